@@ -11,6 +11,38 @@ int abCircleCheck(const AbCircle *circle, const Vec2 *centerPos, const Vec2 *pix
   vec2Abs(&relPos);		      /* project to first quadrant */
   return (relPos.axes[0] <= radius && circle->chords[relPos.axes[0]] >= relPos.axes[1]);
 }
+
+// the circle covers one span per row: the columns whose chords reach row
+int
+abCircleRowSpans(const AbCircle *circle, const Vec2 *centerPos, int row, Span spans[])
+{
+  int radius = circle->radius, halfWidth;
+  row -= centerPos->axes[1];
+  row = (row >= 0) ? row : -row; /* project to first quadrant */
+  if (row > radius)
+    return 0;
+  /* chords are non-increasing: find the last col whose chord reaches row */
+  halfWidth = circle->chords[row];
+  while (halfWidth < radius && circle->chords[halfWidth+1] >= row)
+    halfWidth++;
+  while (halfWidth >= 0 && circle->chords[halfWidth] < row)
+    halfWidth--;
+  if (halfWidth < 0)
+    return 0;
+  spans[0].colMin = centerPos->axes[0] - halfWidth;
+  spans[0].colMax = centerPos->axes[0] + halfWidth;
+  return 1;
+}
+
+static AbShapeClass abCircleClass = {
+  (void *)abCircleCheck, (void *)abCircleRowSpans, 0, ABSHAPE_CUSTOM
+};
+
+void
+abCircleInit()
+{
+  abShapeRegisterClass(&abCircleClass);
+}
   
 void
 abCircleGetBounds(const AbCircle *circle, const Vec2 *centerPos, Region *bounds)
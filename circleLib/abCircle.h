@@ -24,6 +24,15 @@ void abCircleGetBounds(const AbCircle *circle, const Vec2 *circlePos, Region *bo
  */
 int abCircleCheck(const AbCircle *circle, const Vec2 *circlePos, const Vec2 *pixel);
 
+/** Required by AbShapeClass
+ */
+int abCircleRowSpans(const AbCircle *circle, const Vec2 *circlePos, int row, Span spans[]);
+
+/** Registers AbCircle's span query with shapeLib.
+ *  Renderers fall back to abCircleCheck until this is called.
+ */
+void abCircleInit();
+
 #endif
 
 
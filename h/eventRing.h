@@ -0,0 +1,86 @@
+#ifndef eventRing_included
+#define eventRing_included
+
+#include <msp430.h>
+
+/* Single producer, single consumer event rings
+ *
+ * An interrupt handler posts events that the main loop later reads in
+ * order, so events that arrive faster than the main loop runs are
+ * queued rather than overwritten.  The producer only writes head and
+ * the consumer only writes tail, so neither disables interrupts.  Both
+ * are free-running 8 bit counts; the ring's capacity must be a power
+ * of two, at most 128.
+ *
+ * Each event carries a type and a byte of data (both chosen by the
+ * producer) and time, Timer A1's count when it was posted (started by
+ * softTimerInit or profileInit).
+ *
+ * Everything is inline, so libraries that post events (e.g. p2swLib)
+ * do not depend on libTimer.
+ */
+typedef struct {
+  unsigned char type, data;
+  unsigned int time;
+} Event;
+
+typedef struct {
+  volatile unsigned char head;	/* events posted */
+  volatile unsigned char tail;	/* events read */
+  unsigned char mask;		/* capacity - 1 */
+  unsigned char dropped;	/* events posted while full */
+  Event *events;
+} EventRing;
+
+/* e.g. Event keyEvents[8]; EventRing keyRing = EVENT_RING_INIT(keyEvents); */
+#define EVENT_RING_INIT(events) \
+  { 0, 0, sizeof(events) / sizeof(Event) - 1, 0, events }
+
+/* keeps the compiler from moving event accesses past head or tail */
+#define EVENT_RING_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+/* Producer: append an event.  Returns false (and counts it in
+ * dropped) if the ring is full.
+ */
+static inline int
+eventPost(EventRing *ring, unsigned char type, unsigned char data)
+{
+  unsigned char head = ring->head;
+  Event *event;
+  if ((unsigned char)(head - ring->tail) > ring->mask) {
+    ring->dropped++;
+    return 0;
+  }
+  event = &ring->events[head & ring->mask];
+  event->type = type;
+  event->data = data;
+  event->time = TA1R;
+  EVENT_RING_BARRIER();
+  ring->head = head + 1;	/* publish */
+  return 1;
+}
+
+/* Consumer: number of events waiting */
+static inline unsigned char
+eventCount(const EventRing *ring)
+{
+  return ring->head - ring->tail;
+}
+
+/* Consumer: copy the oldest event into event and remove it.
+ * Returns false if the ring is empty.
+ */
+static inline int
+eventGet(EventRing *ring, Event *event)
+{
+  unsigned char tail = ring->tail;
+  if (tail == ring->head)
+    return 0;
+  EVENT_RING_BARRIER();
+  *event = ring->events[tail & ring->mask];
+  EVENT_RING_BARRIER();
+  ring->tail = tail + 1;	/* the slot may now be reused */
+  return 1;
+}
+
+#endif // included
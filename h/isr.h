@@ -0,0 +1,37 @@
+#ifndef isr_included
+#define isr_included
+
+/* Interrupt helpers
+ *
+ * timerLib's interrupt handlers are C functions (__interrupt_vec), so
+ * the compiler saves only the registers they use: R11-R15 around a
+ * call into C, rather than all of R4-R15.
+ *
+ * A handler (or a function it calls, such as wdt_c_handler or a
+ * softTimer callback) that has work for the main loop calls
+ * isrWake().  Handlers ending with ISR_EXIT_WAKE() then leave the CPU
+ * on when they return, so the main loop runs rather than sleeping.
+ * timerLib's watchdog (enableWDTHandler) and softTimer handlers do;
+ * setting a flag such as redrawScreen alone does not wake main.
+ */
+extern volatile unsigned char isrWakeRequested;
+
+#define isrWake() (isrWakeRequested = 1)
+
+#define ISR_EXIT_WAKE() do {			\
+    if (isrWakeRequested) {			\
+      isrWakeRequested = 0;			\
+      __bic_SR_register_on_exit(LPM4_bits);	\
+    }						\
+  } while (0)
+
+/* Cycles from setting *ifgReg's ifgBit (with interrupts enabled) until
+ * its handler has returned, less the cost of the instructions around
+ * it: the interrupt's entry, handler and exit.  Timer A1 must be
+ * counting (softTimerInit or profileInit); the result is a multiple of
+ * the cycles per Timer A1 count (see profile.h).
+ * e.g. isrInterruptCycles(&IFG1, WDTIFG)
+ */
+unsigned int isrInterruptCycles(volatile unsigned char *ifgReg, unsigned char ifgBit);
+
+#endif // included
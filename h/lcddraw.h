@@ -14,6 +14,8 @@
 void drawPixel(u_char col, u_char row, u_int colorBGR);
 
 /** Fill rectangle
+ *  The rectangle is queued (see lcd_queueArea), so this returns while
+ *  its pixels are sent.
  *
  *  \param colMin Column start
  *  \param rowMin Row start
@@ -35,6 +37,10 @@ void clearScreen(u_int colorBGR);
  *  FONT_SM_BKG, FONT_MD_BKG, FONT_LG_BKG - as above, but with background color
  *  Adapted from RobG's EduKit
  *
+ *  The string is streamed a scanline at a time through one window that
+ *  includes the background column between characters.  Characters that
+ *  would extend past the right edge of the screen are not drawn.
+ *
  *  \param col Column to start drawing string
  *  \param row Row to start drawing string
  *  \param string The string
@@ -50,6 +56,91 @@ void drawString5x7(u_char col, u_char row, char *string,
 void drawChar5x7(u_char col, u_char row, char c, 
 		 u_int fgColorBGR, u_int bgColorBGR);
 
+/** 8x12 font - this function draws background pixels
+ */
+void drawChar8x12(u_char col, u_char row, char c, 
+		  u_int fgColorBGR, u_int bgColorBGR);
+
+/** Draw string at col,row using the 8x12 font
+ *  Like drawString5x7, the string is streamed through a single window
+ *  that includes the background column between characters.
+ */
+void drawString8x12(u_char col, u_char row, char *string, 
+		    u_int fgColorBGR, u_int bgColorBGR);
+
+/** 11x16 font - this function draws background pixels
+ *  Glyphs are streamed column by column through a transposed window.
+ */
+void drawChar11x16(u_char col, u_char row, char c, 
+		   u_int fgColorBGR, u_int bgColorBGR);
+
+/** Draw string at col,row using the 11x16 font
+ *  The string (including the column between characters) is one window.
+ */
+void drawString11x16(u_char col, u_char row, char *string, 
+		     u_int fgColorBGR, u_int bgColorBGR);
+
+/** Draw string at col,row using the 11x16 font
+ *  Only foreground pixels are drawn; the background shows through.
+ */
+void drawString11x16Transparent(u_char col, u_char row, char *string, 
+				u_int fgColorBGR);
+
+/** Fill a triangle with arbitrary vertices
+ *  Each row is queued as a single run.
+ *
+ *  \param col0, row0 First vertex
+ *  \param col1, row1 Second vertex
+ *  \param col2, row2 Third vertex
+ *  \param colorBGR Color of triangle in BGR
+ */
+void fillTriangle(u_char col0, u_char row0, u_char col1, u_char row1,
+		  u_char col2, u_char row2, u_int colorBGR);
+
+/** Draw a filled isosceles triangle pointing up, one run per row
+ *
+ *  \param colMin Column left of the triangle's base
+ *  \param rowMin Row above the triangle's apex
+ *  \param height Height of triangle
+ *  \param colorBGR Color of triangle in BGR
+ */
+void drawTriangle(u_char colMin, u_char rowMin, u_char height, u_int colorBGR);
+
+/** Run length encoded color image (usually const, in flash)
+ *
+ *  data holds each row in turn as a sequence of opcodes, each a word
+ *  whose low byte is a pixel count n:
+ *   - RLE_LITERAL | n: n colors follow, one per pixel
+ *   - RLE_RUN | n: one color follows, repeated for n pixels
+ *   - RLE_SKIP | n: n transparent pixels (the screen is left unchanged)
+ *  A row's counts add up to width.  Colors are as written to the LCD
+ *  (wrap 5-6-5 values in LCD_COLOR).  Images are generated from PPM
+ *  files by makeRLE (see README.md).
+ */
+typedef struct {
+  u_char width, height;
+  const u_int *data;
+} RleBitmap;
+
+#define RLE_LITERAL 0x0000
+#define RLE_RUN     0x4000
+#define RLE_SKIP    0x8000
+#define RLE_OP(op)    ((op) & 0xc000)
+#define RLE_COUNT(op) ((op) & 0x00ff)
+
+/** Draw an RLE image with its top left corner at col, row
+ *  Runs are streamed through a window covering the rest of the image,
+ *  so consecutive rows without transparent pixels share one window.
+ *  A transparent run is skipped by opening a window for the rest of
+ *  its row.  Parts beyond the right or bottom edge of the screen are
+ *  not drawn.
+ *
+ *  \param col Column of the image's left edge
+ *  \param row Row of the image's top edge
+ *  \param bitmap The image
+ */
+void drawBitmapRLE(u_char col, u_char row, const RleBitmap *bitmap);
+
 /** Draw rectangle outline
  *  
  *  \param colMin Column start
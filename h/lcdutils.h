@@ -38,7 +38,10 @@ extern const unsigned int colors[43];
 # define screenWidth LONG_EDGE_PIXELS
 #endif
 
-/** Initialize the onboard LCD */
+/** Initialize the onboard LCD
+ *  SPI runs at SMCLK (SMCLK/2 at 16MHz); configureClocksProfile() keeps
+ *  that divider if the profile changes later.
+ */
 void lcd_init();
 
 /** Set area to draw to
@@ -50,60 +53,252 @@ void lcd_init();
  */
 void lcd_setArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd);
 
+/** Set area to draw to, column by column
+ *
+ *  Like lcd_setArea, but pixels are written from top to bottom within
+ *  each column, and columns from left to right.  The next lcd_setArea
+ *  restores row-by-row writes.
+ *  
+ *  \param colStart Start column of the area
+ *  \param rowStart Start row of the area
+ *  \param colEnd End column of the area
+ *  \param rowEnd End row of the area
+ */
+void lcd_setAreaTransposed(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd);
+
+/** Identify the memory write begun by the last lcd_setArea
+ *  (or lcd_queueArea), for lcd_continueArea.
+ */
+u_char lcd_areaId();
+
+/** Continue a sequential write to an area
+ *
+ *  For callers that write an area whole rows at a time and send other
+ *  commands between rows.  area is the lcd_areaId() taken after the
+ *  area was set (or the value last returned), and rowStart is the next
+ *  row to be written.  If that memory write is still open (no command
+ *  and no other window has been sent since), nothing is sent.
+ *  Otherwise this is equivalent to lcd_setArea.
+ *
+ *  \return the identifier to pass to the next call
+ */
+u_char lcd_continueArea(u_char area, u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd);
+
+/** Forget the address window cached by lcd_setArea
+ *  Needed after anything other than lcd_setArea reprograms the window.
+ */
+void lcd_invalidateArea();
+
+/** Hardware vertical scrolling
+ *
+ *  The panel can display its frame memory rotated within a scroll
+ *  area, so a scrolling playfield only needs the rows that become
+ *  visible to be drawn.  Bands of fixed rows above and below the
+ *  scroll area (e.g. a score line) do not move.
+ *
+ *  The panel scrolls along its long edge, so scrolling is only
+ *  available in the vertical orientations (LCD_CAN_SCROLL is defined).
+ */
+#if (ORIENTATION == ORIENTATION_VERTICAL) || (ORIENTATION == ORIENTATION_VERTICAL_ROTATED)
+#define LCD_CAN_SCROLL
+#endif
+
+/** The scroll area is screen rows lcd_scrollTop to
+ *  lcd_scrollTop + lcd_scrollRows - 1, shifted up by lcd_scrollOffset
+ *  rows.  Initially the whole screen with no offset.  Read only.
+ */
+extern u_char lcd_scrollTop, lcd_scrollRows, lcd_scrollOffset;
+
+#ifdef LCD_CAN_SCROLL
+/** Define the scroll area between bands of fixed rows
+ *  The scroll offset is reset to 0.
+ *
+ *  \param topFixed Rows at the top of the screen that do not scroll
+ *  \param bottomFixed Rows at the bottom of the screen that do not scroll
+ */
+void lcd_scrollDefine(u_char topFixed, u_char bottomFixed);
+
+/** Set the scroll offset
+ *  Screen row lcd_scrollTop then displays the row that was drawn at
+ *  lcd_scrollTop + offset; rows wrap around within the scroll area.
+ *
+ *  \param offset 0 to lcd_scrollRows - 1
+ */
+void lcd_scrollTo(u_char offset);
+#endif
+
+/** Map a screen row to the row that lcd_setArea must address for
+ *  pixels to appear there at the current scroll offset.
+ *  Rows outside the scroll area map to themselves.
+ */
+u_char lcd_scrollRow(u_char row);
+
+/** Pixel format
+ *
+ *  By default pixels are 16 bit (5-6-5, COLMOD 0x05).  Building with
+ *  -DLCD_COLOR12 selects 12 bit pixels (4-4-4, COLMOD 0x03): two pixels
+ *  are packed into three bytes, so each pixel costs 1.5 rather than 2
+ *  bytes on the SPI bus.  Colors are then 12 bit values; LCD_COLOR
+ *  converts a 5-6-5 constant at compile time, and the COLOR_* constants
+ *  below are already converted.  Everything linked together must be
+ *  built with the same setting.
+ */
+#ifdef LCD_COLOR12
+#define LCD_COLMOD 0x03
+#define LCD_COLOR(bgr565) \
+  ((((bgr565) >> 4) & 0xf00) | (((bgr565) >> 3) & 0x0f0) | (((bgr565) >> 1) & 0x00f))
+#else
+#define LCD_COLMOD 0x05
+#define LCD_COLOR(bgr565) (bgr565)
+#endif
+
 /** Write color to LCD
+ *  With LCD_COLOR12, a pixel that begins a pair is held until its
+ *  partner arrives, the window is filled, or a command is sent.
  *
  *  \param colorBGR The color in BGR
  */
 void lcd_writeColor(u_int colorBGR);
 
-#define rgb2bgr(val) ((((val) << 11)&0xf800) | ((val)&0x7e0) | (((val)>>11)&0x1f))
+/** Write a run of pixels of the same color to LCD
+ *  Bytes are streamed back-to-back without waiting for each to complete.
+ *
+ *  \param colorBGR The color in BGR
+ *  \param count Number of pixels to write
+ */
+void lcd_writeColorRun(u_int colorBGR, u_int count);
+
+/** Write a buffer of pixels to LCD
+ *  Bytes are streamed back-to-back without waiting for each to complete.
+ *
+ *  \param buf The colors in BGR
+ *  \param count Number of pixels to write
+ */
+void lcd_writeColors(const u_int *buf, u_int count);
+
+/** Send a pixel held back by LCD_COLOR12 (see lcd_writeColor)
+ *  Call after writing fewer pixels than the area holds; the next
+ *  write then needs a new lcd_setArea.  Nothing to do with 16 bit
+ *  pixels.
+ */
+#ifdef LCD_COLOR12
+void lcd_flush();
+#else
+#define lcd_flush()
+#endif
+
+/** Queued output
+ *
+ *  lcd_queueArea and lcd_queueRun are like lcd_setArea and
+ *  lcd_writeColorRun, but append to a small queue that is sent by the
+ *  USCI transmit interrupt, and return at once unless the queue is
+ *  full.  The CPU can meanwhile compute the next output, run game
+ *  logic, or sleep.  lcd_queuePending() is the number of entries not
+ *  yet sent (0 once everything has gone out), and lcd_queueWait(n)
+ *  waits until at most n remain.  Other lcdLib output waits for the
+ *  queue to empty first.  While interrupts are disabled (e.g. in an
+ *  interrupt handler) waiting sends the queue directly.  With
+ *  LCD_COLOR12, and in the host build, queued output is sent before
+ *  these functions return.
+ */
+void lcd_queueArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd);
+void lcd_queueRun(u_int colorBGR, u_int count);
+u_char lcd_queuePending();
+void lcd_queueWait(u_char maxPending);
+
+/** Palette-indexed pixels
+ *
+ *  lcd_writeIndexed queues count pixels whose colors are palette
+ *  entries selected by 4 bit indices, packed two per byte with the
+ *  first pixel in the high nibble.  The caller can prepare the next
+ *  scanline while this one shifts out, but indices and palette must
+ *  not change until it has been sent (see lcd_queueWait).  The
+ *  palette is the caller's, so it only takes the RAM its colors need.
+ */
+#define LCD_PALETTE_SIZE 16	/**< most colors 4 bit indices select */
+void lcd_writeIndexed(const u_char *indices, u_char count, const u_int *palette);
+
+/** Drawing statistics
+ *
+ *  Compiled in only when lcdLib (and the program using these) is built
+ *  with -DLCD_STATS; otherwise nothing is counted and no RAM is used.
+ */
+typedef struct {
+  unsigned long dataBytes;	/**< SPI data bytes */
+  unsigned long commandBytes;	/**< SPI command bytes */
+  unsigned long pixels;		/**< pixels written */
+  u_int setAreaCalls;		/**< calls to lcd_setArea */
+  u_int fillRectangleCalls;	/**< calls to fillRectangle */
+  u_int drawPixelCalls;		/**< calls to drawPixel */
+  u_int drawChar5x7Calls;	/**< calls to drawChar5x7 */
+  u_int drawChar8x12Calls;	/**< calls to drawChar8x12 */
+  u_int addrBytesSaved;		/**< SPI bytes not sent because the address window was cached */
+} LcdStats;
+
+#ifdef LCD_STATS
+extern LcdStats lcd_stats;
+
+#define LCD_STAT_ADD(counter, n) (lcd_stats.counter += (n))
+
+/** Copy the current statistics into snapshot
+ *  (e.g. once per frame, followed by lcd_statsReset)
+ */
+void lcd_statsSnapshot(LcdStats *snapshot);
+
+/** Zero the statistics */
+void lcd_statsReset();
+#else
+#define LCD_STAT_ADD(counter, n) ((void)0)
+#endif
+
+#define rgb2bgr(val) LCD_COLOR((((val) << 11)&0xf800) | ((val)&0x7e0) | (((val)>>11)&0x1f))
 
 /** Colors */
-#define BLACK 0x0000
-#define WHITE 0xFFFF
+#define BLACK LCD_COLOR(0x0000)
+#define WHITE LCD_COLOR(0xFFFF)
 #define COLOR_BLACK   BLACK
 #define COLOR_WHITE   WHITE
 
-#define COLOR_BLUE              0xf800
-#define COLOR_RED 		0x001f
-#define COLOR_GREEN   		0x07e0
-#define COLOR_CYAN    		0xffe0
-#define COLOR_MAGENTA 		0xf81f
-#define COLOR_YELLOW  		0x07ff
-#define COLOR_ORANGE		0x053f
-#define COLOR_ORANGE_RED	0x023f
-#define COLOR_DARK_ORANGE	0x047f
-#define COLOR_GRAY		0xbdf7
-#define COLOR_NAVY		0x8000
-#define COLOR_ROYAL_BLUE	0xe348
-#define COLOR_SKY_BLUE		0xee70
-#define COLOR_TURQUOISE		0xd708
-#define COLOR_STEEL_BLUE	0xb408
-#define COLOR_LIGHT_BLUE	0xe6d5
-#define COLOR_AQUAMARINE	0xd7ef
-#define COLOR_DARK_GREEN	0x0320
-#define COLOR_DARK_OLIVE_GREEN	0x2b4a
-#define COLOR_SEA_GREEN		0x5445
-#define COLOR_SPRING_GREEN	0x7fe0
-#define COLOR_PALE_GREEN	0x9fd3
-#define COLOR_GREEN_YELLOW	0x2ff5
-#define COLOR_LIME_GREEN	0x3666
-#define COLOR_FOREST_GREEN	0x2444
-#define COLOR_KHAKI		0x8f3e
-#define COLOR_GOLD		0x06bf
-#define COLOR_GOLDENROD		0x253b
-#define COLOR_SIENNA		0x2a94
-#define COLOR_BEIGE		0xdfbe
-#define COLOR_TAN		0x8dba
-#define COLOR_BROWN		0x2954
-#define COLOR_CHOCOLATE		0x1b5a
-#define COLOR_FIREBRICK		0x2116
-#define COLOR_HOT_PINK		0xb35f
-#define COLOR_PINK		0xce1f
-#define COLOR_DEEP		0x90bf
-#define COLOR_VIOLET		0xec1d
-#define COLOR_DARK_VIOLE	0xd012
-#define COLOR_PURPLE		0xf114
-#define COLOR_MEDIUM_PURPLE	0xdb92
+#define COLOR_BLUE              LCD_COLOR(0xf800)
+#define COLOR_RED 		LCD_COLOR(0x001f)
+#define COLOR_GREEN   		LCD_COLOR(0x07e0)
+#define COLOR_CYAN    		LCD_COLOR(0xffe0)
+#define COLOR_MAGENTA 		LCD_COLOR(0xf81f)
+#define COLOR_YELLOW  		LCD_COLOR(0x07ff)
+#define COLOR_ORANGE		LCD_COLOR(0x053f)
+#define COLOR_ORANGE_RED	LCD_COLOR(0x023f)
+#define COLOR_DARK_ORANGE	LCD_COLOR(0x047f)
+#define COLOR_GRAY		LCD_COLOR(0xbdf7)
+#define COLOR_NAVY		LCD_COLOR(0x8000)
+#define COLOR_ROYAL_BLUE	LCD_COLOR(0xe348)
+#define COLOR_SKY_BLUE		LCD_COLOR(0xee70)
+#define COLOR_TURQUOISE		LCD_COLOR(0xd708)
+#define COLOR_STEEL_BLUE	LCD_COLOR(0xb408)
+#define COLOR_LIGHT_BLUE	LCD_COLOR(0xe6d5)
+#define COLOR_AQUAMARINE	LCD_COLOR(0xd7ef)
+#define COLOR_DARK_GREEN	LCD_COLOR(0x0320)
+#define COLOR_DARK_OLIVE_GREEN	LCD_COLOR(0x2b4a)
+#define COLOR_SEA_GREEN		LCD_COLOR(0x5445)
+#define COLOR_SPRING_GREEN	LCD_COLOR(0x7fe0)
+#define COLOR_PALE_GREEN	LCD_COLOR(0x9fd3)
+#define COLOR_GREEN_YELLOW	LCD_COLOR(0x2ff5)
+#define COLOR_LIME_GREEN	LCD_COLOR(0x3666)
+#define COLOR_FOREST_GREEN	LCD_COLOR(0x2444)
+#define COLOR_KHAKI		LCD_COLOR(0x8f3e)
+#define COLOR_GOLD		LCD_COLOR(0x06bf)
+#define COLOR_GOLDENROD		LCD_COLOR(0x253b)
+#define COLOR_SIENNA		LCD_COLOR(0x2a94)
+#define COLOR_BEIGE		LCD_COLOR(0xdfbe)
+#define COLOR_TAN		LCD_COLOR(0x8dba)
+#define COLOR_BROWN		LCD_COLOR(0x2954)
+#define COLOR_CHOCOLATE		LCD_COLOR(0x1b5a)
+#define COLOR_FIREBRICK		LCD_COLOR(0x2116)
+#define COLOR_HOT_PINK		LCD_COLOR(0xb35f)
+#define COLOR_PINK		LCD_COLOR(0xce1f)
+#define COLOR_DEEP		LCD_COLOR(0x90bf)
+#define COLOR_VIOLET		LCD_COLOR(0xec1d)
+#define COLOR_DARK_VIOLE	LCD_COLOR(0xd012)
+#define COLOR_PURPLE		LCD_COLOR(0xf114)
+#define COLOR_MEDIUM_PURPLE	LCD_COLOR(0xdb92)
 
 #endif /* lcdutils_included */
@@ -0,0 +1,62 @@
+/** \file shapeSpans.h
+ *  \brief Row span computations for the shapes defined in shapeLib
+ *
+ *  Shared by the classes' rowSpans functions and by the compositor
+ *  (layer.c), which inlines them rather than calling through the class.
+ *  Internal to shapeLib.
+ */
+
+#ifndef shapeSpans_included
+#define shapeSpans_included
+
+#include "shape.h"
+
+// the rect covers one span in rows within its bounds
+static inline int
+rectSpans(const AbRect *rect, const Vec2 *centerPos, int row, Span spans[])
+{
+  int rowOffset = row - centerPos->axes[1];
+  int halfWidth = rect->halfSize.axes[0];
+  if (rowOffset < -rect->halfSize.axes[1] || rowOffset > rect->halfSize.axes[1])
+    return 0;
+  spans[0].colMin = centerPos->axes[0] - halfWidth;
+  spans[0].colMax = centerPos->axes[0] + halfWidth;
+  return 1;
+}
+
+// top & bottom rows are a single span, other rows are the two sides
+static inline int
+rectOutlineSpans(const AbRectOutline *rect, const Vec2 *centerPos, int row, Span spans[])
+{
+  int rowOffset = row - centerPos->axes[1];
+  int halfHeight = rect->halfSize.axes[1], halfWidth = rect->halfSize.axes[0];
+  int colLeft = centerPos->axes[0] - halfWidth, colRight = centerPos->axes[0] + halfWidth;
+  if (rowOffset < -halfHeight || rowOffset > halfHeight)
+    return 0;
+  if (rowOffset == -halfHeight || rowOffset == halfHeight || halfWidth == 0) {
+    spans[0].colMin = colLeft;
+    spans[0].colMax = colRight;
+    return 1;
+  }
+  spans[0].colMin = spans[0].colMax = colLeft;
+  spans[1].colMin = spans[1].colMax = colRight;
+  return 2;
+}
+
+// rows within the stem extend from the tail to the tip's edge
+static inline int
+rArrowSpans(const AbRArrow *arrow, const Vec2 *centerPos, int row, Span spans[])
+{
+  int size = arrow->size;
+  int halfSize = size/2, quarterSize = halfSize/2;
+  int tipCol = centerPos->axes[0];
+  row -= centerPos->axes[1];
+  row = (row >= 0) ? row : -row;/* row = |row| */
+  if (row > halfSize)		/* above or below arrow */
+    return 0;
+  spans[0].colMin = tipCol - ((row <= quarterSize) ? size : halfSize);
+  spans[0].colMax = tipCol - row;
+  return 1;
+}
+
+#endif // included
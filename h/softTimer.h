@@ -0,0 +1,38 @@
+#ifndef softTimer_included
+#define softTimer_included
+
+/* Software timers driven by Timer A1
+ *
+ * Timers are kept in a list sorted by deadline, each storing its
+ * distance from the one before it.  Timer A1 counts continuously and
+ * its CCR0 interrupt is programmed for the first deadline (or, for
+ * distant ones, every 0x8000 counts: about 131ms in the 2MHz clock
+ * profile and 16ms in the 16MHz profile), so the CPU is not woken
+ * between deadlines.  When no timer is
+ * running, the interrupt is disabled.
+ *
+ * callback is called from the interrupt handler.  If it returns true,
+ * the CPU is left on (out of low power mode) when the handler returns,
+ * so the main loop can run.  Callbacks may start and stop timers.
+ */
+typedef struct SoftTimer_s {
+  int (*callback)(struct SoftTimer_s *timer);
+  unsigned int period;		/* ms between calls, 0 for one-shot */
+  unsigned long delta;		/* private: counts after previous timer */
+  struct SoftTimer_s *next;	/* private */
+} SoftTimer;
+
+/* Start Timer A1.  Call after configureClocks() or configureClocksProfile()
+ * and before starting timers.
+ */
+void softTimerInit();
+
+/* Call timer's callback in ms (1..65535) milliseconds, and then every
+ * timer->period ms if that is nonzero.  Restarts timer if running.
+ */
+void softTimerStart(SoftTimer *timer, unsigned int ms);
+
+/* Stop timer (no effect if it is not running) */
+void softTimerStop(SoftTimer *timer);
+
+#endif // included
@@ -0,0 +1,28 @@
+/** \file st7735.h
+ *  \brief ST7735 LCD driver IC command set (as used by lcdutils and lcdemu)
+ */
+
+#ifndef st7735_included
+#define st7735_included
+
+/** LCD driver IC specific defines */
+#define SWRESET							0x01
+#define	SLEEPOUT						0x11
+#define DISPON							0x29
+#define CASETP							0x2A
+#define PASETP							0x2B
+#define RAMWRP							0x2C
+#define VSCRDEF							0x33
+#define	MADCTL							0x36
+#define VSCRSACC						0x37
+#define	COLMOD							0x3A
+#define GMCTRP1							0xE0
+#define GMCTRN1							0xE1
+
+/** MADCTL bits */
+#define MADCTL_MY						0x80 /**< row address order */
+#define MADCTL_MX						0x40 /**< column address order */
+#define MADCTL_MV						0x20 /**< row/column exchange */
+#define MADCTL_BGR						0x08 /**< BGR color order */
+
+#endif // included
@@ -0,0 +1,137 @@
+/** \file lcdbench.c
+ *  \brief Renders a shapemotion-like scene with lcdLib's host emulator
+ *
+ *  For each phase of rendering, reports the SPI traffic (commands,
+ *  data bytes and pixels) and the time it would occupy the bus.
+ *  The final frame is written to lcdbench.ppm (or the file named by
+ *  the first argument).
+ */
+#include <stdio.h>
+#include <lcdutils.h>
+#include <lcddraw.h>
+#include <lcdemu.h>
+#include <shape.h>
+#include <abCircle.h>
+#include "../lcdLib/images/ship.h"
+
+AbRect rect10 = {abRectGetBounds, abRectCheck, {10,10}}; /**< 10x10 rectangle */
+AbRArrow rightArrow = {abRArrowGetBounds, abRArrowCheck, 30};
+
+AbRectOutline fieldOutline = {	/* playing field */
+  abRectOutlineGetBounds, abRectOutlineCheck,   
+  {screenWidth/2 - 10, screenHeight/2 - 10}
+};
+
+Layer layer4 = {
+  (AbShape *)&rightArrow,
+  {(screenWidth/2)+10, (screenHeight/2)+5}, /**< bit below & right of center */
+  {0,0}, {0,0},				    /* last & next pos */
+  COLOR_PINK,
+  0
+};
+
+Layer layer3 = {		/**< Layer with a violet circle */
+  (const AbShape *)&circle8,
+  {(screenWidth/2)+10, (screenHeight/2)+5}, /**< bit below & right of center */
+  {0,0}, {0,0},				    /* last & next pos */
+  COLOR_VIOLET,
+  &layer4,
+};
+
+Layer fieldLayer = {		/* playing field as a layer */
+  (AbShape *) &fieldOutline,
+  {screenWidth/2, screenHeight/2},/**< center */
+  {0,0}, {0,0},				    /* last & next pos */
+  COLOR_BLACK,
+  &layer3
+};
+
+Layer layer1 = {		/**< Layer with a red square */
+  (AbShape *)&rect10,
+  {screenWidth/2, screenHeight/2}, /**< center */
+  {0,0}, {0,0},				    /* last & next pos */
+  COLOR_RED,
+  &fieldLayer,
+};
+
+Layer layer0 = {		/**< Layer with an orange circle */
+  (const AbShape *)&circle14,
+  {(screenWidth/2)+10, (screenHeight/2)+5}, /**< bit below & right of center */
+  {0,0}, {0,0},				    /* last & next pos */
+  COLOR_ORANGE,
+  &layer1,
+};
+
+u_int bgColor = COLOR_BLUE;     /**< The background color */
+
+u_char scanlines[2 * (screenWidth / 2)]; /**< two screen wide rows of indices */
+u_int palette[LCD_PALETTE_SIZE];
+
+/** Print and reset the emulator's counters and lcdLib's statistics */
+void
+report(const char *phase)
+{
+  LcdStats stats;
+  lcd_statsSnapshot(&stats);
+  printf("%-16s %8lu cmds %8lu data %8lu pixels %9.3f ms %5u setArea\n", phase,
+	 lcdEmu_counts.commands, lcdEmu_counts.dataBytes, lcdEmu_counts.pixels,
+	 1000 * lcdEmu_busSeconds(), stats.setAreaCalls);
+  lcdEmu_resetCounts();
+  lcd_statsReset();
+}
+
+/** Print and reset shapeLib's compositor statistics */
+void
+reportLayers()
+{
+  LayerStats stats;
+  layerStatsSnapshot(&stats);
+  printf("%-16s %8u rects %8lu painted %8lu changed\n", "  dirty",
+	 stats.rects, stats.pixelsPainted, stats.pixelsChanged);
+  layerStatsReset();
+}
+
+int
+main(int argc, char **argv)
+{
+  int frame;
+  lcd_init();
+  abCircleInit();
+  report("init");
+
+  clearScreen(COLOR_BLUE);
+  report("clearScreen");
+
+  layerUseScanlines(scanlines, screenWidth, palette, LCD_PALETTE_SIZE);
+  layerInit(&layer0);
+  layerDraw(&layer0);
+  report("layerDraw");
+
+  layerStatsReset();
+  for (frame = 0; frame < 15; frame++) { /* move two layers, redraw what changed */
+    layer0.pos.axes[0] += 2; layer0.pos.axes[1] += 1;
+    layer1.pos.axes[0] += 1; layer1.pos.axes[1] += 2;
+    layerRedrawDirty(&layer0);
+  }
+  report("15 moves");
+  reportLayers();
+
+  drawString5x7(20,20, "hello", COLOR_GREEN, COLOR_RED);
+  drawString8x12(20,140, "score!", COLOR_YELLOW, COLOR_BLACK);
+  drawString11x16(20,40, "P1 3", COLOR_WHITE, COLOR_BLACK);
+  drawString11x16Transparent(40,110, "10", COLOR_YELLOW);
+  report("strings");
+
+  drawTriangle(10, 100, 20, COLOR_ORANGE);
+  report("drawTriangle");
+
+  drawBitmapRLE(90, 100, &ship);
+  report("drawBitmapRLE");
+
+  lcd_scrollDefine(0, 24);	/* keep the score line fixed */
+  for (frame = 0; frame < 10; frame++)
+    layerScroll(&layer0, 4);
+  report("10 scrolls by 4");
+
+  return lcdEmu_writePPM(argc > 1 ? argv[1] : "lcdbench.ppm") ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+/** \file msp430.h
+ *  \brief The MSP430 registers and intrinsics used by timerLib's
+ *  softTimer, for building it with the host's C compiler
+ *
+ *  Registers are variables driven by timersim.c, which plays the part
+ *  of Timer A1.  Only what softTimer.c and the headers it includes
+ *  use is defined.
+ */
+#ifndef host_msp430_included
+#define host_msp430_included
+
+extern volatile unsigned char BCSCTL2;
+extern volatile unsigned int TA1R, TA1CCR0, TA1CCTL0, TA1CTL;
+
+#define DIVS_0 0x00
+#define DIVS_1 0x02
+#define DIVS_3 0x06
+
+#define TASSEL_2 0x0200
+#define ID_3 0x00c0
+#define MC_2 0x0020
+#define TACLR 0x0004
+#define CCIE 0x0010
+#define CCIFG 0x0001
+
+#define GIE 0x0008
+#define LPM4_bits 0x00f0
+
+#define TIMER1_A0_VECTOR 13
+
+/** Handlers are called by the simulation like ordinary functions */
+#define __interrupt_vec(vector)
+
+/** Counts the handlers that would leave the CPU on */
+extern unsigned int hostWakes;
+#define __bic_SR_register_on_exit(bits) (hostWakes++)
+
+#endif // included
@@ -0,0 +1,248 @@
+/** \file timersim.c
+ *  \brief Checks timerLib's softTimer against a simulated Timer A1
+ *
+ *  softTimer.c is built unchanged against msp430.h in this directory.
+ *  Timer A1 is advanced a count at a time and its CCR0 interrupt is
+ *  taken as the hardware would take it.  In the 2MHz and 16MHz clock
+ *  profiles, checks that timers are called on the count they are due,
+ *  that periodic timers do not drift, that restarts, stops from
+ *  callbacks, deadlines beyond one arming of CCR0 and callbacks that
+ *  run long are handled, and that the CPU is left on only when a
+ *  callback asks for it.  Exits with status 1 if a check fails.
+ */
+#include <stdio.h>
+#include <msp430.h>
+#include "libTimer.h"
+
+volatile unsigned char BCSCTL2;
+volatile unsigned int TA1R, TA1CCR0, TA1CCTL0, TA1CTL;
+volatile unsigned char isrWakeRequested;
+unsigned int hostWakes;
+
+static int sr = GIE;
+int get_sr(void) { return sr; }
+void set_sr(int sr_val) { sr = sr_val; }
+void and_sr(int and_val) { sr &= and_val; }
+void or_sr(int or_val) { sr |= or_val; }
+
+void softTimerInterrupt();
+
+static unsigned long now;	/* counts since the test began */
+static unsigned long countsPerMs;
+static unsigned long interrupts; /* CCR0 interrupts taken */
+static int wantWake;		/* a callback returned true in this interrupt */
+static int failures;
+
+static void
+check(const char *test, const char *what, int ok)
+{
+  if (ok)
+    return;
+  printf("  FAIL %s: %s\n", test, what);
+  failures++;
+}
+
+/** Take the CCR0 interrupt for as long as it is pending */
+static void
+serviceInterrupt()
+{
+  while ((sr & GIE) && (TA1CCTL0 & CCIE) && (TA1CCTL0 & CCIFG)) {
+    unsigned int wakes = hostWakes;
+    TA1CCTL0 &= ~CCIFG;		/* cleared when the interrupt is taken */
+    sr &= ~GIE;
+    wantWake = 0;
+    softTimerInterrupt();
+    sr |= GIE;
+    interrupts++;
+    check("interrupt", "CPU left on exactly when a callback asked",
+	  hostWakes - wakes == (unsigned int)wantWake);
+  }
+}
+
+/** Advance Timer A1 by one count */
+static void
+tick()
+{
+  TA1R++;
+  now++;
+  if (TA1R == TA1CCR0)
+    TA1CCTL0 |= CCIFG;
+  serviceInterrupt();
+}
+
+static void
+runUntil(unsigned long ms)
+{
+  while (now < ms * countsPerMs)
+    tick();
+}
+
+/** A timer whose calls are checked against the counts they were due */
+typedef struct Probe_s {
+  SoftTimer timer;		/* first, so the callback can find the probe */
+  unsigned long due;		/* count the next call is due */
+  unsigned int calls;
+  unsigned int early;		/* calls before they were due */
+  unsigned long late, lastLate;	/* counts the latest, and last, call was late */
+  int wake;			/* callback's result */
+  void (*action)(struct Probe_s *probe); /* run after each call */
+} Probe;
+
+static int
+probeCall(SoftTimer *timer)
+{
+  Probe *p = (Probe *)timer;
+  if (now < p->due)
+    p->early++;
+  else {
+    p->lastLate = now - p->due;
+    if (p->lastLate > p->late)
+      p->late = p->lastLate;
+  }
+  p->due += timer->period * countsPerMs;
+  p->calls++;
+  if (p->action)
+    p->action(p);
+  if (p->wake)
+    wantWake = 1;
+  return p->wake;
+}
+
+static void
+probeInit(Probe *p, unsigned int period, int wake, void (*action)(Probe *))
+{
+  Probe init = {{probeCall, period}};
+  *p = init;
+  p->wake = wake;
+  p->action = action;
+}
+
+static void
+probeStart(Probe *p, unsigned int ms)
+{
+  softTimerStart(&p->timer, ms);
+  p->due = now + ms * countsPerMs;
+  serviceInterrupt();		/* may already be due */
+}
+
+static void
+checkOnTime(const char *test, const Probe *p, unsigned int calls)
+{
+  check(test, "number of calls", p->calls == calls);
+  check(test, "no call before it was due", !p->early);
+  check(test, "every call on its count", !p->late);
+}
+
+/* periodic timers, a one-shot, a restart and stops from a callback */
+static Probe fast, slow, oneShot, restarted, stopper, stopped;
+
+static void
+stopperAction(Probe *p)
+{
+  if (p->calls == 3)
+    softTimerStop(&stopped.timer);
+  if (p->calls == 5)
+    softTimerStop(&p->timer);	/* itself, after it has been rescheduled */
+}
+
+static void
+testPeriodic()
+{
+  const char *test = "periodic";
+  probeInit(&fast, 61, 0, 0);
+  probeInit(&slow, 1000, 1, 0);
+  probeInit(&oneShot, 0, 1, 0);
+  probeInit(&restarted, 0, 1, 0);
+  probeInit(&stopper, 20, 1, stopperAction);
+  probeInit(&stopped, 7, 1, 0);
+  probeStart(&fast, 61);
+  probeStart(&slow, 1000);
+  probeStart(&stopper, 20);
+  probeStart(&stopped, 7);
+  probeStart(&restarted, 300);
+  runUntil(100);
+  probeStart(&oneShot, 500);
+  probeStart(&restarted, 50);	/* while running: now due at 150ms */
+  runUntil(5000);
+  softTimerStop(&fast.timer);
+  softTimerStop(&slow.timer);
+  checkOnTime(test, &fast, 5000 / 61);
+  checkOnTime(test, &slow, 5);
+  checkOnTime(test, &oneShot, 1);
+  checkOnTime(test, &restarted, 1);
+  checkOnTime(test, &stopper, 5);
+  checkOnTime(test, &stopped, 60 / 7);
+}
+
+/* a deadline much further away than CCR0 can be armed for */
+static void
+testDistant()
+{
+  const char *test = "distant";
+  unsigned long counts = 65535 * countsPerMs;
+  probeInit(&oneShot, 0, 1, 0);
+  interrupts = 0;
+  probeStart(&oneShot, 65535);
+  runUntil(65536);
+  checkOnTime(test, &oneShot, 1);
+  check(test, "CPU woken only every 0x8000 counts",
+	interrupts <= (counts + 0x7fff) / 0x8000);
+}
+
+/* a callback that runs past the next deadlines */
+static Probe longRunner, overtaken;
+
+static void
+longRunnerAction(Probe *p)
+{
+  unsigned long end = now + 25 * countsPerMs;
+  if (p->calls != 2)
+    return;
+  while (now < end) {		/* interrupts are disabled in the handler */
+    TA1R++;
+    now++;
+    if (TA1R == TA1CCR0)
+      TA1CCTL0 |= CCIFG;
+  }
+}
+
+static void
+testLongCallback()
+{
+  const char *test = "long callback";
+  probeInit(&longRunner, 10, 1, longRunnerAction);
+  probeInit(&overtaken, 0, 1, 0);
+  probeStart(&longRunner, 10);
+  probeStart(&overtaken, 25);
+  runUntil(100);
+  softTimerStop(&longRunner.timer);
+  check(test, "missed deadlines are caught up", longRunner.calls == 10);
+  check(test, "period does not drift", !longRunner.early && !longRunner.lastLate);
+  check(test, "overtaken timer called once, late", overtaken.calls == 1
+	&& !overtaken.early && overtaken.late <= 25 * countsPerMs);
+}
+
+static void
+runProfile(unsigned char profile, const char *name)
+{
+  int before = failures;
+  void (*tests[])() = {testPeriodic, testDistant, testLongCallback};
+  unsigned int i;
+  BCSCTL2 = profile * DIVS_1;
+  countsPerMs = 250UL << (CLOCKS_SMCLK_2MHZ - profile);
+  for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    softTimerInit();
+    TA1R = 0;			/* TACLR */
+    now = 0;
+    tests[i]();
+  }
+  printf("%s profile: %s\n", name, failures == before ? "ok" : "FAILED");
+}
+
+int
+main()
+{
+  runProfile(CLOCKS_SMCLK_2MHZ, "2MHz");
+  runProfile(CLOCKS_SMCLK_16MHZ, "16MHz");
+  return failures != 0;
+}
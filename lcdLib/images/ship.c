@@ -0,0 +1,23 @@
+// Automatically generated by makeRLE from ship.ppm
+#include "ship.h"
+
+static const u_int shipData[] = {
+  /* row 0 */ RLE_SKIP|7, RLE_LITERAL|2, LCD_COLOR(0xffff), LCD_COLOR(0xffff), RLE_SKIP|7,
+  /* row 1 */ RLE_SKIP|6, RLE_LITERAL|4, LCD_COLOR(0xffff), LCD_COLOR(0xfa85), LCD_COLOR(0xfa85), LCD_COLOR(0xffff), RLE_SKIP|6,
+  /* row 2 */ RLE_SKIP|6, RLE_LITERAL|4, LCD_COLOR(0xffff), LCD_COLOR(0xfa85), LCD_COLOR(0xfa85), LCD_COLOR(0xffff), RLE_SKIP|6,
+  /* row 3 */ RLE_SKIP|5, RLE_LITERAL|6, LCD_COLOR(0xffff), LCD_COLOR(0xffff), LCD_COLOR(0xfe4f), LCD_COLOR(0xfe4f), LCD_COLOR(0xffff), LCD_COLOR(0xffff), RLE_SKIP|5,
+  /* row 4 */ RLE_SKIP|5, RLE_LITERAL|1, LCD_COLOR(0xffff), RLE_RUN|4, LCD_COLOR(0xfe4f), RLE_LITERAL|1, LCD_COLOR(0xffff), RLE_SKIP|5,
+  /* row 5 */ RLE_SKIP|4, RLE_LITERAL|2, LCD_COLOR(0xffff), LCD_COLOR(0xffff), RLE_RUN|4, LCD_COLOR(0xfe4f), RLE_LITERAL|2, LCD_COLOR(0xffff), LCD_COLOR(0xffff), RLE_SKIP|4,
+  /* row 6 */ RLE_SKIP|2, RLE_LITERAL|1, LCD_COLOR(0x18fb), RLE_SKIP|1, RLE_LITERAL|1, LCD_COLOR(0xffff), RLE_RUN|6, LCD_COLOR(0xa4b2), RLE_LITERAL|1, LCD_COLOR(0xffff), RLE_SKIP|1, RLE_LITERAL|1, LCD_COLOR(0x18fb), RLE_SKIP|2,
+  /* row 7 */ RLE_SKIP|2, RLE_LITERAL|2, LCD_COLOR(0x18fb), LCD_COLOR(0xffff), RLE_RUN|8, LCD_COLOR(0xa4b2), RLE_LITERAL|2, LCD_COLOR(0xffff), LCD_COLOR(0x18fb), RLE_SKIP|2,
+  /* row 8 */ RLE_SKIP|1, RLE_LITERAL|5, LCD_COLOR(0x18fb), LCD_COLOR(0x18fb), LCD_COLOR(0xffff), LCD_COLOR(0xa4b2), LCD_COLOR(0xa4b2), RLE_RUN|4, LCD_COLOR(0x06ff), RLE_LITERAL|5, LCD_COLOR(0xa4b2), LCD_COLOR(0xa4b2), LCD_COLOR(0xffff), LCD_COLOR(0x18fb), LCD_COLOR(0x18fb), RLE_SKIP|1,
+  /* row 9 */ RLE_SKIP|1, RLE_LITERAL|5, LCD_COLOR(0x18fb), LCD_COLOR(0xffff), LCD_COLOR(0xffff), LCD_COLOR(0xa4b2), LCD_COLOR(0xa4b2), RLE_RUN|4, LCD_COLOR(0x06ff), RLE_LITERAL|5, LCD_COLOR(0xa4b2), LCD_COLOR(0xa4b2), LCD_COLOR(0xffff), LCD_COLOR(0xffff), LCD_COLOR(0x18fb), RLE_SKIP|1,
+  /* row 10 */ RLE_LITERAL|3, LCD_COLOR(0x18fb), LCD_COLOR(0x18fb), LCD_COLOR(0xffff), RLE_RUN|10, LCD_COLOR(0xa4b2), RLE_LITERAL|3, LCD_COLOR(0xffff), LCD_COLOR(0x18fb), LCD_COLOR(0x18fb),
+  /* row 11 */ RLE_LITERAL|1, LCD_COLOR(0x18fb), RLE_RUN|4, LCD_COLOR(0xffff), RLE_RUN|6, LCD_COLOR(0xa4b2), RLE_RUN|4, LCD_COLOR(0xffff), RLE_LITERAL|1, LCD_COLOR(0x18fb),
+  /* row 12 */ RLE_LITERAL|1, LCD_COLOR(0x18fb), RLE_SKIP|3, RLE_RUN|8, LCD_COLOR(0xffff), RLE_SKIP|3, RLE_LITERAL|1, LCD_COLOR(0x18fb),
+  /* row 13 */ RLE_SKIP|5, RLE_LITERAL|2, LCD_COLOR(0x047f), LCD_COLOR(0x047f), RLE_SKIP|2, RLE_LITERAL|2, LCD_COLOR(0x047f), LCD_COLOR(0x047f), RLE_SKIP|5,
+  /* row 14 */ RLE_SKIP|5, RLE_LITERAL|2, LCD_COLOR(0x06ff), LCD_COLOR(0x047f), RLE_SKIP|2, RLE_LITERAL|2, LCD_COLOR(0x047f), LCD_COLOR(0x06ff), RLE_SKIP|5,
+  /* row 15 */ RLE_SKIP|6, RLE_LITERAL|1, LCD_COLOR(0x06ff), RLE_SKIP|2, RLE_LITERAL|1, LCD_COLOR(0x06ff), RLE_SKIP|6,
+};
+
+const RleBitmap ship = {16, 16, shipData};
@@ -0,0 +1,10 @@
+// Automatically generated by makeRLE from ship.ppm
+#ifndef ship_included
+#define ship_included
+
+#include "lcdutils.h"
+#include "lcddraw.h"
+
+extern const RleBitmap ship;
+
+#endif // included
@@ -1,12 +1,13 @@
 /** \file lcddemo.c
- *  \brief A simple demo that draws a string and square
+ *  \brief A simple demo that draws a string, a square and a sprite
  */
 
 #include <libTimer.h>
 #include "lcdutils.h"
 #include "lcddraw.h"
+#include "images/ship.h"
 
-/** Initializes everything, clears the screen, draws "hello" and a square */
+/** Initializes everything, clears the screen, draws "hello", a square and a ship */
 int
 main()
 {
@@ -19,5 +20,7 @@ main()
   drawString5x7(20,20, "hello", COLOR_GREEN, COLOR_RED);
 
   fillRectangle(30,30, 60, 60, COLOR_ORANGE);
+
+  drawBitmapRLE(52, 100, &ship);	/* transparent around the ship */
   
 }
@@ -4,6 +4,47 @@
 #include "lcdutils.h"
 #include "lcddraw.h"
 
+/** Pixels of one color waiting to be written by lcd_writeColorRun */
+typedef struct {
+  u_int color, length;
+} ColorRun;
+
+/** Append a pixel to run, writing the run out when the color changes */
+static inline void
+runAppend(ColorRun *run, u_int colorBGR)
+{
+  if (run->length && colorBGR != run->color) {
+    lcd_writeColorRun(run->color, run->length);
+    run->length = 0;
+  }
+  run->color = colorBGR;
+  run->length++;
+}
+
+/** Write out any pixels remaining in run */
+static inline void
+runFlush(ColorRun *run)
+{
+  if (run->length)
+    lcd_writeColorRun(run->color, run->length);
+  run->length = 0;
+}
+
+/** Number of characters of string (advancing charCols each) that fit
+ *  on screen starting at col
+ */
+static u_char
+stringCharsOnScreen(u_char col, const char *string, u_char charCols)
+{
+  u_char numChars = 0;
+  int colLimit = col;
+  while (string[numChars] && colLimit + charCols - 1 <= screenWidth) {
+    numChars++;
+    colLimit += charCols;
+  }
+  return numChars;
+}
+
 
 /** Draw single pixel at x,row 
  *
@@ -13,6 +54,7 @@
  */
 void drawPixel(u_char col, u_char row, u_int colorBGR) 
 {
+  LCD_STAT_ADD(drawPixelCalls, 1);
   lcd_setArea(col, row, col, row);
   lcd_writeColor(colorBGR);
 }
@@ -29,19 +71,105 @@ void fillRectangle(u_char colMin, u_char rowMin, u_char width, u_char height,
 		   u_int colorBGR)
 {
   u_char colLimit = colMin + width, rowLimit = rowMin + height;
-  lcd_setArea(colMin, rowMin, colLimit - 1, rowLimit - 1);
-  u_int total = width * height;
-  u_int c = 0;
-  while ((c++) < total) {
-    lcd_writeColor(colorBGR);
+  LCD_STAT_ADD(fillRectangleCalls, 1);
+  lcd_queueArea(colMin, rowMin, colLimit - 1, rowLimit - 1);
+  lcd_queueRun(colorBGR, width * height);
+}
+
+/** Walks an edge of a triangle one row at a time without multiplies */
+typedef struct {
+  int col, colStep;		/* current column, direction (1 or -1) */
+  int dCol, dRow, err;		/* |column change|, row change, accumulated error */
+} TriEdge;
+
+static void
+triEdgeInit(TriEdge *e, int col0, int row0, int col1, int row1)
+{
+  e->col = col0;
+  e->dRow = row1 - row0;
+  e->dCol = col1 - col0;
+  e->colStep = 1;
+  if (e->dCol < 0) {
+    e->dCol = -e->dCol;
+    e->colStep = -1;
   }
+  e->err = e->dRow >> 1;	/* round to nearest column */
 }
 
+/** Advance to the next row */
+static inline void
+triEdgeStep(TriEdge *e)
+{
+  if (!e->dRow)
+    return;
+  e->err += e->dCol;
+  while (e->err >= e->dRow) {
+    e->col += e->colStep;
+    e->err -= e->dRow;
+  }
+}
+
+/** Fill one row of a triangle from col0 to col1 (in either order) */
+static void
+triFillRow(int col0, int col1, int row, u_int colorBGR)
+{
+  if (col0 > col1) {
+    int t = col0; col0 = col1; col1 = t;
+  }
+  if (col0 < 0) col0 = 0;
+  if (col1 > screenWidth - 1) col1 = screenWidth - 1;
+  if (col0 > col1 || row >= screenHeight)
+    return;
+  lcd_queueArea(col0, row, col1, row);
+  lcd_queueRun(colorBGR, col1 - col0 + 1);
+}
+
+void fillTriangle(u_char col0, u_char row0, u_char col1, u_char row1,
+		  u_char col2, u_char row2, u_int colorBGR)
+{
+  TriEdge longEdge, shortEdge;
+  u_char t, row;
+
+  /* sort vertices by row: row0 <= row1 <= row2 */
+  if (row1 < row0) { t = row0; row0 = row1; row1 = t; t = col0; col0 = col1; col1 = t; }
+  if (row2 < row1) { t = row1; row1 = row2; row2 = t; t = col1; col1 = col2; col2 = t; }
+  if (row1 < row0) { t = row0; row0 = row1; row1 = t; t = col0; col0 = col1; col1 = t; }
+
+  if (row0 == row2) {		/* degenerate: a single row */
+    u_char colMin = col0, colMax = col0;
+    if (col1 < colMin) colMin = col1;
+    if (col2 < colMin) colMin = col2;
+    if (col1 > colMax) colMax = col1;
+    if (col2 > colMax) colMax = col2;
+    triFillRow(colMin, colMax, row0, colorBGR);
+    return;
+  }
+
+  triEdgeInit(&longEdge, col0, row0, col2, row2);
+  triEdgeInit(&shortEdge, col0, row0, col1, row1);
+  for (row = row0; ; row++) {
+    if (row == row1)		/* switch to the lower short edge */
+      triEdgeInit(&shortEdge, col1, row1, col2, row2);
+    triFillRow(longEdge.col, shortEdge.col, row, colorBGR);
+    if (row == row2)
+      break;
+    triEdgeStep(&longEdge);
+    triEdgeStep(&shortEdge);
+  }
+}
+
+/** Isosceles triangle pointing up, one run per row.  Columns wrap
+ *  modulo 256, as they did when it was drawn with drawPixel.
+ */
 void drawTriangle(u_char colMin, u_char rowMin, u_char height, u_int colorBGR){
-  for (int row = 1; row< height+1; row++){
-    for (int col = 1; col < (row+(row-1)); col++){
-      drawPixel((col+colMin)+(height-row), row+rowMin, colorBGR);
-    }
+  int r;
+  for (r = 2; r <= height; r++) { /* row 1 is empty */
+    u_char row = rowMin + r;
+    int left = colMin + height - r + 1, right = colMin + height + r - 2;
+    if (row >= screenHeight)
+      continue;
+    for (; right >= 0; left -= 256, right -= 256) /* each wrap onto the screen */
+      triFillRow(left, right, row, colorBGR);
   }
 }
 
@@ -68,6 +196,7 @@ void drawChar5x7(u_char rcol, u_char rrow, char c,
   u_char bit = 0x01;
   u_char oc = c - 0x20;
 
+  LCD_STAT_ADD(drawChar5x7Calls, 1);
   lcd_setArea(rcol, rrow, rcol + 4, rrow + 7); /* relative to requested col/row */
   while (row < 8) {
     while (col < 5) {
@@ -96,11 +225,24 @@ void drawChar5x7(u_char rcol, u_char rrow, char c,
 void drawString5x7(u_char col, u_char row, char *string,
 		u_int fgColorBGR, u_int bgColorBGR)
 {
-  u_char cols = col;
-  while (*string) {
-    drawChar5x7(cols, row, *string++, fgColorBGR, bgColorBGR);
-    cols += 6;
+  u_char numChars = stringCharsOnScreen(col, string, 6);
+  u_char bit, c, glyphCol;
+  ColorRun run = {0, 0};
+  if (!numChars)
+    return;
+
+  /* one window for the whole string, including the column between chars */
+  lcd_setArea(col, row, col + 6 * numChars - 2, row + 7);
+  for (bit = 0x01; bit; bit <<= 1) { /* each scanline */
+    for (c = 0; c < numChars; c++) {
+      const u_char *glyph = font_5x7[string[c] - 0x20];
+      if (c)
+	runAppend(&run, bgColorBGR); /* spacing column */
+      for (glyphCol = 0; glyphCol < 5; glyphCol++)
+	runAppend(&run, (glyph[glyphCol] & bit) ? fgColorBGR : bgColorBGR);
+    }
   }
+  runFlush(&run);
 }
 
 
@@ -130,7 +272,8 @@ void drawChar8x12(u_char rcol, u_char rrow, char c, u_int fgColorBGR, u_int bgCo
   u_char bit = 0x80;
   u_char oc = c - 0x20;
 
-  lcd_setArea(rcol, rrow, rcol + 7, rrow + 12);
+  LCD_STAT_ADD(drawChar8x12Calls, 1);
+  lcd_setArea(rcol, rrow, rcol + 7, rrow + 11);
   while(row < 12){
     while(col < 8){
       u_int colorBGR = (font_8x12[oc][row] & bit) ? fgColorBGR : bgColorBGR;
@@ -144,10 +287,166 @@ void drawChar8x12(u_char rcol, u_char rrow, char c, u_int fgColorBGR, u_int bgCo
   }
 }
 
+/** Draw string at col,row using the 8x12 font
+ *  The whole string (including the column between chars) is one window.
+ */
 void drawString8x12(u_char col, u_char row, char *string, u_int fgColorBGR, u_int bgColorBGR){
-  u_char cols = col;
-  while(*string){
-    drawChar8x12(cols, row, *string++, fgColorBGR, bgColorBGR);
-    cols += 9;
+  u_char numChars = stringCharsOnScreen(col, string, 9);
+  u_char glyphRow, c, bit;
+  ColorRun run = {0, 0};
+  if (!numChars)
+    return;
+
+  lcd_setArea(col, row, col + 9 * numChars - 2, row + 11);
+  for (glyphRow = 0; glyphRow < 12; glyphRow++) { /* each scanline */
+    for (c = 0; c < numChars; c++) {
+      u_char bits = font_8x12[string[c] - 0x20][glyphRow];
+      if (c)
+	runAppend(&run, bgColorBGR); /* spacing column */
+      for (bit = 0x80; bit; bit >>= 1)
+	runAppend(&run, (bits & bit) ? fgColorBGR : bgColorBGR);
+    }
   }
+  runFlush(&run);
+}
+
+/** Draw numChars of string in the 11x16 font (private)
+ *  Glyphs are stored as one 16 bit word per column (bit 0 at top),
+ *  so they are streamed through a transposed window a column at a time.
+ *  If opaque is false, only foreground pixels are written: one
+ *  single-column window per vertical run of set bits.
+ */
+static void
+drawGlyphs11x16(u_char col, u_char row, const char *string, u_char numChars,
+		u_int fgColorBGR, u_int bgColorBGR, u_char opaque)
+{
+  u_char c, glyphCol;
+  ColorRun run = {0, 0};
+
+  if (opaque)			/* one window for the whole string */
+    lcd_setAreaTransposed(col, row, col + 12 * numChars - 2, row + 15);
+  for (c = 0; c < numChars; c++) {
+    const u_int *glyph = font_11x16[string[c] - 0x20];
+    if (c && opaque)
+      for (glyphCol = 0; glyphCol < 16; glyphCol++)
+	runAppend(&run, bgColorBGR); /* spacing column */
+    for (glyphCol = 0; glyphCol < 11; glyphCol++, col++) {
+      u_int bits = glyph[glyphCol];
+      u_char bit;
+      if (opaque) {
+	for (bit = 0; bit < 16; bit++, bits >>= 1)
+	  runAppend(&run, (bits & 1) ? fgColorBGR : bgColorBGR);
+	continue;
+      }
+      for (bit = 0; bits; bit++, bits >>= 1) { /* find runs of set bits */
+	if (bits & 1) {
+	  u_char runStart = bit;
+	  while (bits & 2) {
+	    bits >>= 1;
+	    bit++;
+	  }
+	  lcd_setAreaTransposed(col, row + runStart, col, row + bit);
+	  lcd_writeColorRun(fgColorBGR, bit - runStart + 1);
+	}
+      }
+    }
+    col++;			/* spacing column */
+  }
+  runFlush(&run);
+}
+
+/** 11x16 font - this function draws background pixels
+ */
+void drawChar11x16(u_char col, u_char row, char c, u_int fgColorBGR, u_int bgColorBGR)
+{
+  if (col + 10 < screenWidth)
+    drawGlyphs11x16(col, row, &c, 1, fgColorBGR, bgColorBGR, 1);
+}
+
+/** Draw string at col,row using the 11x16 font */
+void drawString11x16(u_char col, u_char row, char *string, u_int fgColorBGR, u_int bgColorBGR)
+{
+  u_char numChars = stringCharsOnScreen(col, string, 12);
+  if (numChars)
+    drawGlyphs11x16(col, row, string, numChars, fgColorBGR, bgColorBGR, 1);
+}
+
+/** Draw string at col,row using the 11x16 font without background pixels */
+void drawString11x16Transparent(u_char col, u_char row, char *string, u_int fgColorBGR)
+{
+  u_char numChars = stringCharsOnScreen(col, string, 12);
+  drawGlyphs11x16(col, row, string, numChars, fgColorBGR, 0, 0);
+}
+
+/** Where the next pixel written to an RLE image's window will appear */
+typedef struct {
+  u_char col, row;		/* relative to the image */
+  u_char open;			/* the window reaches (col, row) */
+  u_char multiRow;		/* the window continues to the following rows */
+} RleCursor;
+
+/** Prepare to write pixels at (x, y) of an image at col, row whose
+ *  visible part is width x height (screen clipped)
+ */
+static void
+rleSeek(RleCursor *cursor, u_char x, u_char y, u_char col, u_char row,
+	u_char width, u_char height)
+{
+  if (cursor->open && cursor->col == x && cursor->row == y)
+    return;
+  cursor->multiRow = (x == 0);	/* full rows: keep going to the last row */
+  lcd_setArea(col + x, row + y, col + width - 1,
+	      cursor->multiRow ? row + height - 1 : row + y);
+  cursor->col = x;
+  cursor->row = y;
+  cursor->open = 1;
+}
+
+/** Account for count pixels written at the cursor */
+static void
+rleAdvance(RleCursor *cursor, u_char count, u_char width)
+{
+  cursor->col += count;
+  if (cursor->col < width)
+    return;
+  cursor->col = 0;		/* the window wraps to the next row */
+  cursor->row++;
+  cursor->open = cursor->multiRow;
+}
+
+void
+drawBitmapRLE(u_char col, u_char row, const RleBitmap *bitmap)
+{
+  const u_int *data = bitmap->data;
+  u_char width = bitmap->width, height = bitmap->height, y;
+  RleCursor cursor = {0, 0, 0, 0};
+  if (col >= screenWidth || row >= screenHeight)
+    return;
+  u_char visibleWidth = (width < screenWidth - col) ? width : screenWidth - col;
+  u_char visibleHeight = (height < screenHeight - row) ? height : screenHeight - row;
+
+  for (y = 0; y < visibleHeight; y++) {
+    u_char x = 0;
+    while (x < width) {
+      u_int op = *data++;
+      u_char count = RLE_COUNT(op), visible;
+      const u_int *colors = data;
+      if (RLE_OP(op) == RLE_LITERAL)
+	data += count;
+      else if (RLE_OP(op) == RLE_RUN)
+	data++;
+      visible = (x >= visibleWidth) ? 0
+	: (count < visibleWidth - x) ? count : visibleWidth - x;
+      if (RLE_OP(op) != RLE_SKIP && visible) {
+	rleSeek(&cursor, x, y, col, row, visibleWidth, visibleHeight);
+	if (RLE_OP(op) == RLE_RUN)
+	  lcd_writeColorRun(*colors, visible);
+	else
+	  lcd_writeColors(colors, visible);
+	rleAdvance(&cursor, visible, visibleWidth);
+      }
+      x += count;
+    } // for each opcode in row
+  } // for each row
+  lcd_flush();			/* the last window may end in a skip */
 }
@@ -0,0 +1,220 @@
+/** \file lcdemu.c
+ *  \brief Host-side ST7735 emulator
+ *
+ *  Decodes the byte stream produced by lcdutils.c (built with LCD_HOST)
+ *  into a framebuffer.  Supports SWRESET, CASET, PASET, RAMWR, MADCTL
+ *  (MY, MX, MV and BGR), COLMOD (12, 16 and 18 bit pixels), and
+ *  vertical scrolling (VSCRDEF and VSCRSACC).
+ *  Other commands are counted and their parameters ignored.
+ */
+
+#include <stdio.h>
+#include "lcdutils.h"
+#include "st7735.h"
+#include "lcdemu.h"
+
+u_int lcdEmu_fb[LCDEMU_HEIGHT][LCDEMU_WIDTH];
+u_char lcdEmu_dcPin = 1;
+unsigned long lcdEmu_sclkHz = 2000000;
+LcdEmuCounts lcdEmu_counts;
+
+static u_char command;		/**< last command received */
+static u_char params[6];	/**< parameter bytes received for command */
+static u_char numParams;
+static u_char madctl = 0, colmod = 0x06; /**< reset defaults */
+static u_char colStart = 0, colEnd = LCDEMU_WIDTH-1;
+static u_char rowStart = 0, rowEnd = LCDEMU_HEIGHT-1;
+static u_char col, row;		/**< RAM write pointer (logical) */
+static int scrollTop = 0, scrollRows = LCDEMU_HEIGHT; /**< VSCRDEF TFA and VSA */
+static int scrollStart = 0;	/**< VSCRSACC: memory line at top of scroll area */
+static u_char pixelBytes[3];	/**< partially received pixel data */
+static u_char numPixelBytes;
+
+/** Store a pixel at the write pointer and advance it */
+static void
+writePixel(u_int color)
+{
+  int physCol = col, physRow = row;
+  if (madctl & MADCTL_MV) {	/* row/column exchange */
+    physCol = row;
+    physRow = col;
+  }
+  if (madctl & MADCTL_MX)
+    physCol = LCDEMU_WIDTH - 1 - physCol;
+  if (madctl & MADCTL_MY)
+    physRow = LCDEMU_HEIGHT - 1 - physRow;
+  if (physCol >= 0 && physCol < LCDEMU_WIDTH && physRow >= 0 && physRow < LCDEMU_HEIGHT)
+    lcdEmu_fb[physRow][physCol] = color;
+  lcdEmu_counts.pixels++;
+
+  if (col < colEnd)		/* advance column, then row, then wrap */
+    col++;
+  else {
+    col = colStart;
+    row = (row < rowEnd) ? row + 1 : rowStart;
+  }
+}
+
+/** Expand 4 bit components of a 12 bit pixel to a 5-6-5 word */
+static u_int
+expand444(u_char c1, u_char c2, u_char c3)
+{
+  return ((c1 << 1 | c1 >> 3) << 11) | ((c2 << 2 | c2 >> 2) << 5) | (c3 << 1 | c3 >> 3);
+}
+
+/** Accumulate RAMWR data into pixels according to COLMOD */
+static void
+ramData(u_char byte)
+{
+  pixelBytes[numPixelBytes++] = byte;
+  switch (colmod & 0x07) {
+  case 0x03:			/* 12 bit: 2 pixels in 3 bytes, each stored once complete */
+    if (numPixelBytes == 2)
+      writePixel(expand444(pixelBytes[0] >> 4, pixelBytes[0] & 0xf, pixelBytes[1] >> 4));
+    else if (numPixelBytes == 3) {
+      writePixel(expand444(pixelBytes[1] & 0xf, pixelBytes[2] >> 4, pixelBytes[2] & 0xf));
+      numPixelBytes = 0;
+    }
+    break;
+  case 0x05:			/* 16 bit */
+    if (numPixelBytes == 2) {
+      writePixel(pixelBytes[0] << 8 | pixelBytes[1]);
+      numPixelBytes = 0;
+    }
+    break;
+  default:			/* 18 bit: 6 bits in the top of each byte */
+    if (numPixelBytes == 3) {
+      writePixel((pixelBytes[0] >> 3) << 11 | (pixelBytes[1] >> 2) << 5 | pixelBytes[2] >> 3);
+      numPixelBytes = 0;
+    }
+  }
+}
+
+static void
+beginCommand(u_char byte)
+{
+  command = byte;
+  numParams = 0;
+  numPixelBytes = 0;		/* a command abandons a partial pixel */
+  switch (command) {
+  case SWRESET:
+    madctl = 0; colmod = 0x06;
+    colStart = 0; colEnd = LCDEMU_WIDTH-1;
+    rowStart = 0; rowEnd = LCDEMU_HEIGHT-1;
+    scrollTop = 0; scrollRows = LCDEMU_HEIGHT; scrollStart = 0;
+    break;
+  case RAMWRP:
+    col = colStart;
+    row = rowStart;
+    break;
+  }
+}
+
+static void
+commandData(u_char byte)
+{
+  if (command == RAMWRP) {
+    ramData(byte);
+    return;
+  }
+  if (numParams < sizeof(params))
+    params[numParams] = byte;
+  numParams++;
+  switch (command) {
+  case CASETP:
+    if (numParams == 4) {
+      colStart = params[1];
+      colEnd = params[3];
+    }
+    break;
+  case PASETP:
+    if (numParams == 4) {
+      rowStart = params[1];
+      rowEnd = params[3];
+    }
+    break;
+  case VSCRDEF:
+    if (numParams == 6) {
+      scrollTop = params[0] << 8 | params[1];
+      scrollRows = params[2] << 8 | params[3];
+    }
+    break;
+  case VSCRSACC:
+    if (numParams == 2)
+      scrollStart = params[0] << 8 | params[1];
+    break;
+  case MADCTL:
+    madctl = byte;
+    break;
+  case COLMOD:
+    colmod = byte;
+    break;
+  }
+}
+
+void
+lcdEmu_tx(u_char byte)
+{
+  if (lcdEmu_dcPin) {
+    lcdEmu_counts.dataBytes++;
+    commandData(byte);
+  } else {
+    lcdEmu_counts.commands++;
+    beginCommand(byte);
+  }
+}
+
+void
+lcdEmu_resetCounts()
+{
+  lcdEmu_counts.commands = lcdEmu_counts.dataBytes = lcdEmu_counts.pixels = 0;
+}
+
+double
+lcdEmu_busSeconds()
+{
+  return 8.0 * (lcdEmu_counts.commands + lcdEmu_counts.dataBytes) / lcdEmu_sclkHz;
+}
+
+u_int
+lcdEmu_getPixel(u_char col, u_char row)
+{
+  return lcdEmu_fb[row][col];
+}
+
+/** Frame memory line shown on display line */
+static int
+displayedLine(int line)
+{
+  if (line < scrollTop || line >= scrollTop + scrollRows
+      || scrollStart < scrollTop || scrollStart >= scrollTop + scrollRows)
+    return line;
+  return scrollTop + (line - scrollTop + scrollStart - scrollTop) % scrollRows;
+}
+
+u_int
+lcdEmu_getDisplayPixel(u_char col, u_char row)
+{
+  return lcdEmu_fb[displayedLine(row)][col];
+}
+
+int
+lcdEmu_writePPM(const char *filename)
+{
+  int r, c;
+  FILE *fp = fopen(filename, "wb");
+  if (!fp)
+    return -1;
+  fprintf(fp, "P6\n%d %d\n255\n", LCDEMU_WIDTH, LCDEMU_HEIGHT);
+  for (r = 0; r < LCDEMU_HEIGHT; r++) {
+    for (c = 0; c < LCDEMU_WIDTH; c++) {
+      u_int color = lcdEmu_fb[displayedLine(r)][c];
+      u_char hi = (color >> 11) & 0x1f, mid = (color >> 5) & 0x3f, lo = color & 0x1f;
+      u_char red = (madctl & MADCTL_BGR) ? lo : hi, blue = (madctl & MADCTL_BGR) ? hi : lo;
+      putc(red << 3 | red >> 2, fp);
+      putc(mid << 2 | mid >> 4, fp);
+      putc(blue << 3 | blue >> 2, fp);
+    }
+  }
+  return fclose(fp);
+}
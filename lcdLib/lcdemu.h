@@ -0,0 +1,57 @@
+/** \file lcdemu.h
+ *  \brief Host-side ST7735 emulator used when lcdLib is built with LCD_HOST
+ *
+ *  lcdutils.c sends its SPI bytes to lcdEmu_tx() instead of the USCI.
+ *  The emulator decodes the command stream as the panel would into a
+ *  128x160 framebuffer and counts the traffic, so renderers can be
+ *  benchmarked and compared against reference images without a board.
+ */
+
+#ifndef lcdemu_included
+#define lcdemu_included
+
+#include "lcdutils.h"
+
+/** Panel dimensions (physical, independent of MADCTL) */
+#define LCDEMU_WIDTH	SHORT_EDGE_PIXELS
+#define LCDEMU_HEIGHT	LONG_EDGE_PIXELS
+
+/** Framebuffer in physical panel coordinates (16 bit colors as written) */
+extern u_int lcdEmu_fb[LCDEMU_HEIGHT][LCDEMU_WIDTH];
+
+/** State of the D/C pin: 1 for data, 0 for command */
+extern u_char lcdEmu_dcPin;
+
+/** SPI clock used to compute bus time (default 2 MHz, as on the board) */
+extern unsigned long lcdEmu_sclkHz;
+
+/** Traffic counters */
+typedef struct {
+  unsigned long commands;	/**< command bytes */
+  unsigned long dataBytes;	/**< data bytes */
+  unsigned long pixels;		/**< pixels written to the framebuffer */
+} LcdEmuCounts;
+
+extern LcdEmuCounts lcdEmu_counts;
+
+/** Transmit one byte on the emulated SPI bus */
+void lcdEmu_tx(u_char byte);
+
+/** Reset traffic counters */
+void lcdEmu_resetCounts();
+
+/** Seconds the counted bytes would occupy the bus at lcdEmu_sclkHz */
+double lcdEmu_busSeconds();
+
+/** Color of a pixel in physical panel coordinates (frame memory) */
+u_int lcdEmu_getPixel(u_char col, u_char row);
+
+/** Color of a pixel as displayed (after vertical scrolling) */
+u_int lcdEmu_getDisplayPixel(u_char col, u_char row);
+
+/** Write the displayed image as a binary PPM (P6) image
+ *  \return 0 on success
+ */
+int lcdEmu_writePPM(const char *filename);
+
+#endif // included
@@ -9,9 +9,25 @@
  */
  
 #include "lcdutils.h"
-#include "msp430.h"
+#include "st7735.h"
 
-u_char _orientation = 0;
+/** Output queue (see lcd_queueArea): entries qHead up to qTail are unsent */
+static volatile u_char qHead = 0, qTail = 0;
+
+#ifdef LCD_HOST			/* host build: bytes go to the emulator */
+#include "lcdemu.h"
+
+#define LCD_DC_LO() (lcdEmu_dcPin = 0)
+#define LCD_DC_HI() (lcdEmu_dcPin = 1)
+#define LCD_TX(data) lcdEmu_tx(data)
+#define LCD_WAIT_IDLE()
+#define LCD_WAIT_TXBUF()
+#define LCD_DC_IS_HI() lcdEmu_dcPin
+#define LCD_INTERRUPTS_ON() 0	/**< queued output is sent synchronously */
+#define __delay_cycles(n)
+
+#else
+#include "msp430.h"
 
 /** LCD pin definitions*/
 /** SCLK & MOSI*/
@@ -40,20 +56,44 @@ u_char _orientation = 0;
 #define LCD_DC_LO() LCD_DC_OUT &= ~LCD_DC_PIN
 #define LCD_DC_HI() LCD_DC_OUT |= LCD_DC_PIN
 
-/** LCD driver IC specific defines */
-#define SWRESET							0x01
-#define	SLEEPOUT						0x11
-#define DISPON							0x29
-#define CASETP							0x2A
-#define PASETP							0x2B
-#define RAMWRP							0x2C
-#define	MADCTL							0x36
-#define	COLMOD							0x3A
-#define GMCTRP1							0xE0
-#define GMCTRN1							0xE1
+/** USCI convenience defines */
+#define LCD_TX(data) (UCB0TXBUF = (data))
+#define LCD_DC_IS_HI() (LCD_DC_OUT & LCD_DC_PIN)
+#define LCD_WAIT_IDLE() do { if (qHead != qTail) lcd_queueWait(0); \
+    while (UCB0STAT & UCBUSY); } while (0)
+#define LCD_WAIT_TXBUF() while (!(IFG2 & UCB0TXIFG))
+#define LCD_INTERRUPTS_ON() (readSR() & GIE)
+
+/** Status register (like timerLib's get_sr, which may be linked after lcdLib) */
+static inline u_int
+readSR()
+{
+  u_int sr;
+  __asm__ __volatile__ ("mov r2, %0" : "=r" (sr));
+  return sr;
+}
+#endif
+
+u_char _orientation = 0;
+
+#ifdef LCD_STATS
+LcdStats lcd_stats;
+
+void lcd_statsSnapshot(LcdStats *snapshot)
+{
+  *snapshot = lcd_stats;
+}
+
+void lcd_statsReset()
+{
+  static const LcdStats zeroStats;
+  lcd_stats = zeroStats;
+}
+#endif
 
 /** Set up onboard LCD's SPI and control pins */
 static void setUpSPIforLCD() {
+#ifndef LCD_HOST
   LCD_DC_OUT |= LCD_DC_PIN;
   LCD_DC_DIR |= LCD_DC_PIN;
   
@@ -70,10 +110,11 @@ static void setUpSPIforLCD() {
   UCB0CTL1 |= UCSWRST;
   UCB0CTL0 = UCCKPH + UCMSB + UCMST + UCSYNC; /**< 3-pin, 8-bit SPI master */
   UCB0CTL1 |= UCSSEL_2; /**< SMCLK */
-  UCB0BR0 |= 0x01; /**< 1:1 */
+  UCB0BR0 = (BCSCTL2 & DIVS_3) ? 1 : 2; /**< SMCLK, at most 8MHz (ST7735: 15MHz) */
   UCB0BR1 = 0;
   UCB0CTL1 &= ~UCSWRST;
   LCD_SELECT();
+#endif
 }
 
 /** Screen dimensions */
@@ -82,11 +123,135 @@ static void setUpSPIforLCD() {
 static inline void 
 lcd_writeData(u_char data) 
 {
-  while (UCB0STAT & UCBUSY);	/**< wait for previous transfer to complete */
+  LCD_WAIT_IDLE();	/**< wait for previous transfer to complete */
   LCD_DC_HI();			/**< specify sending data */
-  UCB0TXBUF = data;		/**< send data */
+  LCD_TX(data);		/**< send data */
+  LCD_STAT_ADD(dataBytes, 1);
+}
+
+/** Address window last sent to the panel (cache is invalid when colStart > colEnd) */
+static u_char areaColStart = 1, areaColEnd = 0, areaRowStart = 1, areaRowEnd = 0;
+static u_char ramwrOpen = 0;	/**< true while RAMWR data may continue */
+static u_char areaSerial = 0;	/**< changed each time a memory write is begun */
+
+#ifdef LCD_COLOR12
+
+/** Two 12 bit pixels are sent as three bytes: RG BR GB (one letter per
+ *  nibble).  The last nibble of a pair's first pixel waits in
+ *  pendingNibble until the second pixel arrives.
+ */
+static u_char pixelPending = 0;	/**< true while pendingNibble is unsent */
+static u_char pendingNibble;
+static u_int windowPixels, windowPixelsLeft; /**< size of window, pixels until it is full */
+
+/** Send the pending nibble (padded), completing the odd pixel.
+ *  The padding begins a pixel the panel will never complete, so the
+ *  next write must start with a fresh RAMWR.
+ */
+static void
+flushPixel()
+{
+  if (!pixelPending)
+    return;
+  LCD_WAIT_IDLE();
+  LCD_DC_HI();
+  LCD_TX(pendingNibble << 4);
+  LCD_STAT_ADD(dataBytes, 1);
+  pixelPending = 0;
+  ramwrOpen = 0;
 }
 
+/** Pack one pixel (D/C must already be high) */
+static inline void
+txPixel(u_int color)
+{
+  if (!pixelPending) {
+    LCD_WAIT_TXBUF();
+    LCD_TX(color >> 4);
+    pendingNibble = color & 0xf;
+    pixelPending = 1;
+    LCD_STAT_ADD(dataBytes, 1);
+  } else {
+    LCD_WAIT_TXBUF();
+    LCD_TX(pendingNibble << 4 | (color >> 8 & 0xf));
+    LCD_WAIT_TXBUF();
+    LCD_TX(color);
+    pixelPending = 0;
+    LCD_STAT_ADD(dataBytes, 2);
+  }
+}
+
+/** Account for count pixels; an odd pixel is flushed once the window is full */
+static void
+windowAdvance(u_int count)
+{
+  if (count < windowPixelsLeft) {
+    windowPixelsLeft -= count;
+    return;
+  }
+  windowPixelsLeft = windowPixels;
+  LCD_WAIT_IDLE();
+  flushPixel();
+}
+
+void lcd_flush()
+{
+  flushPixel();
+}
+
+void lcd_writeColor(u_int colorBGR)
+{
+  LCD_STAT_ADD(pixels, 1);
+  LCD_WAIT_IDLE();
+  LCD_DC_HI();
+  txPixel(colorBGR);
+  windowAdvance(1);
+}
+
+void lcd_writeColorRun(u_int colorBGR, u_int count)
+{
+  u_char b0 = colorBGR >> 4;	/**< the repeating three byte pattern */
+  u_char b1 = colorBGR << 4 | (colorBGR >> 8 & 0xf);
+  u_char b2 = colorBGR;
+  u_int pairs, total = count;
+  if (!count)
+    return;
+  LCD_STAT_ADD(pixels, count);
+  LCD_WAIT_IDLE();	/**< previous byte may be a command */
+  LCD_DC_HI();			/**< specify sending data */
+  if (pixelPending) {		/**< complete the pending pair */
+    txPixel(colorBGR);
+    count--;
+  }
+  LCD_STAT_ADD(dataBytes, 3L * (count >> 1));
+  for (pairs = count >> 1; pairs; pairs--) {
+    LCD_WAIT_TXBUF();
+    LCD_TX(b0);
+    LCD_WAIT_TXBUF();
+    LCD_TX(b1);
+    LCD_WAIT_TXBUF();
+    LCD_TX(b2);
+  }
+  if (count & 1)
+    txPixel(colorBGR);
+  windowAdvance(total);
+  LCD_WAIT_IDLE();	/**< wait for last byte to shift out */
+}
+
+void lcd_writeColors(const u_int *buf, u_int count)
+{
+  u_int total = count;
+  LCD_STAT_ADD(pixels, count);
+  LCD_WAIT_IDLE();	/**< previous byte may be a command */
+  LCD_DC_HI();			/**< specify sending data */
+  while (count--)
+    txPixel(*buf++);
+  windowAdvance(total);
+  LCD_WAIT_IDLE();	/**< wait for last byte to shift out */
+}
+
+#else /* 16 bit pixels */
+
 typedef union {
   u_char colorBytes[2];
   u_int colorBGRWord;
@@ -95,16 +260,62 @@ typedef union {
 void lcd_writeColor(u_int colorBGR)
 {
   ColorBGR colorU = {.colorBGRWord = colorBGR};
+  LCD_STAT_ADD(pixels, 1);
   lcd_writeData(colorU.colorBytes[1]);
   lcd_writeData(colorU.colorBytes[0]);
 }
 
+/** Write count pixels of one color to LCD
+ *
+ *  D/C is set once and the TX buffer is reloaded as soon as it empties,
+ *  so the next byte is queued while the current one shifts out.
+ */
+void lcd_writeColorRun(u_int colorBGR, u_int count)
+{
+  u_char hi = colorBGR >> 8, lo = colorBGR;
+  LCD_STAT_ADD(pixels, count);
+  LCD_STAT_ADD(dataBytes, 2L * count);
+  LCD_WAIT_IDLE();	/**< previous byte may be a command */
+  LCD_DC_HI();			/**< specify sending data */
+  while (count--) {
+    LCD_WAIT_TXBUF();
+    LCD_TX(hi);
+    LCD_WAIT_TXBUF();
+    LCD_TX(lo);
+  }
+  LCD_WAIT_IDLE();	/**< wait for last byte to shift out */
+}
+
+/** Write count pixels from buf to LCD (pipelined like lcd_writeColorRun) */
+void lcd_writeColors(const u_int *buf, u_int count)
+{
+  LCD_STAT_ADD(pixels, count);
+  LCD_STAT_ADD(dataBytes, 2L * count);
+  LCD_WAIT_IDLE();	/**< previous byte may be a command */
+  LCD_DC_HI();			/**< specify sending data */
+  while (count--) {
+    u_int colorBGR = *buf++;
+    LCD_WAIT_TXBUF();
+    LCD_TX(colorBGR >> 8);
+    LCD_WAIT_TXBUF();
+    LCD_TX(colorBGR);
+  }
+  LCD_WAIT_IDLE();	/**< wait for last byte to shift out */
+}
+
+#endif /* LCD_COLOR12 */
+
 /** Write command to LCD (private) */
 void _writeCommand(u_char command) 
 {
-  while (UCB0STAT & UCBUSY);	/**< wait for previous transfer to complete */
+#ifdef LCD_COLOR12
+  flushPixel();			/**< complete an odd pixel first */
+#endif
+  LCD_WAIT_IDLE();	/**< wait for previous transfer to complete */
   LCD_DC_LO();			          /**< specify sending a command */
-  UCB0TXBUF = command;		    /**< send command */
+  LCD_TX(command);		    /**< send command */
+  LCD_STAT_ADD(commandBytes, 1);
+  ramwrOpen = 0;		    /**< any command ends a memory write */
 }
 
 /** Long delay (private) */
@@ -115,47 +326,439 @@ void _delay(u_char x10ms) {
 	}
 }
 
+static u_char madctlValue;	/**< MADCTL for ORIENTATION */
+static u_char transposed = 0;	/**< true while MADCTL's MV bit is inverted */
+
+/** Program the address window and begin a memory write (private)
+ *  MADCTL is first rewritten if the window is to be filled in the
+ *  other order (transpose), with the bounds already exchanged.
+ *  CASET and PASET are only sent when their range differs from the
+ *  window already programmed into the panel.
+ */
+static void
+setAddressWindow(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd,
+		 u_char transpose)
+{
+  LCD_STAT_ADD(setAreaCalls, 1);
+  if (transpose != transposed) {
+    _writeCommand(MADCTL);
+    lcd_writeData(transpose ? madctlValue ^ MADCTL_MV : madctlValue);
+    transposed = transpose;
+  }
+  if (colStart != areaColStart || colEnd != areaColEnd) {
+    _writeCommand(CASETP);
+    lcd_writeData(0);
+    lcd_writeData(colStart);
+    lcd_writeData(0);
+    lcd_writeData(colEnd);
+    areaColStart = colStart; areaColEnd = colEnd;
+  } else
+    LCD_STAT_ADD(addrBytesSaved, 5);
+  if (rowStart != areaRowStart || rowEnd != areaRowEnd) {
+    _writeCommand(PASETP);
+    lcd_writeData(0);
+    lcd_writeData(rowStart);
+    lcd_writeData(0);
+    lcd_writeData(rowEnd);
+    areaRowStart = rowStart; areaRowEnd = rowEnd;
+  } else
+    LCD_STAT_ADD(addrBytesSaved, 5);
+  _writeCommand(RAMWRP);
+  ramwrOpen = 1;
+  areaSerial++;
+#ifdef LCD_COLOR12
+  windowPixelsLeft = windowPixels = (colEnd - colStart + 1) * (rowEnd - rowStart + 1);
+#endif
+}
+
 /** Set area to draw to */
 void lcd_setArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd) 
 {
-	_writeCommand(CASETP);
-	lcd_writeData(0);
-	lcd_writeData(colStart);
-	lcd_writeData(0);
-	lcd_writeData(colEnd);
-	_writeCommand(PASETP);
-	lcd_writeData(0);
-	lcd_writeData(rowStart);
-	lcd_writeData(0);
-	lcd_writeData(rowEnd);
-	_writeCommand(RAMWRP);
+  setAddressWindow(colStart, rowStart, colEnd, rowEnd, 0);
+}
+
+/** Set area to draw to, column by column
+ *  Exchanging rows and columns (MADCTL MV) makes the panel advance
+ *  down each column; the address window is exchanged to match.
+ */
+void lcd_setAreaTransposed(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd) 
+{
+  setAddressWindow(rowStart, colStart, rowEnd, colEnd, 1);
+}
+
+/** Identify the memory write begun by the last lcd_setArea */
+u_char lcd_areaId()
+{
+  return areaSerial;
+}
+
+/** Continue a sequential write */
+u_char lcd_continueArea(u_char area, u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd)
+{
+  if (!ramwrOpen || area != areaSerial) { /**< otherwise pointer is already at rowStart */
+    lcd_setArea(colStart, rowStart, colEnd, rowEnd);
+    area = areaSerial;
+  }
+  return area;
+}
+
+/** Forget the cached address window */
+void lcd_invalidateArea()
+{
+  areaColStart = areaRowStart = 1;
+  areaColEnd = areaRowEnd = 0;
+  ramwrOpen = 0;
+}
+
+#ifdef LCD_COLOR12
+
+/* Packing 12 bit pixels is left to the foreground: queued output is
+ * sent before these return.
+ */
+void lcd_queueArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd)
+{
+  lcd_setArea(colStart, rowStart, colEnd, rowEnd);
+}
+
+void lcd_queueRun(u_int colorBGR, u_int count)
+{
+  lcd_writeColorRun(colorBGR, count);
+}
+
+void lcd_writeIndexed(const u_char *indices, u_char count, const u_int *palette)
+{
+  u_char i;
+  LCD_STAT_ADD(pixels, count);
+  LCD_WAIT_IDLE();
+  LCD_DC_HI();
+  for (i = 0; i < count; i++)
+    txPixel(palette[(i & 1) ? indices[i >> 1] & 0xf : indices[i >> 1] >> 4]);
+  windowAdvance(count);
+  LCD_WAIT_IDLE();
+}
+
+u_char lcd_queuePending()
+{
+  return 0;
+}
+
+void lcd_queueWait(u_char maxPending)
+{
+}
+
+#else /* 16 bit pixels */
+
+#define LCD_QUEUE_SIZE 2	/**< entries (a power of 2), one is kept free */
+#define LCD_QUEUE_MASK (LCD_QUEUE_SIZE - 1)
+
+/** Keeps the compiler from moving entry accesses past qHead/qTail */
+#define QUEUE_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+enum { QUEUE_AREA, QUEUE_RUN, QUEUE_INDEXED };
+#define QUEUE_CASET 1		/**< QUEUE_AREA flags: send the column range */
+#define QUEUE_PASET 2		/**< send the row range */
+
+/** Output queued for the USCI transmit interrupt */
+typedef struct {
+  u_char op, flags;
+  union {
+    u_char window[4];		/**< QUEUE_AREA: colStart, colEnd, rowStart, rowEnd */
+    u_int colorBGR;		/**< QUEUE_RUN */
+    struct {
+      const u_char *indices;	/**< QUEUE_INDEXED: next byte of indices */
+      const u_int *palette;
+    } indexed;
+  } u;
+  u_int count;			/**< pixels not yet begun */
+} QueueEntry;
+
+static QueueEntry queue[LCD_QUEUE_SIZE];
+
+/* progress through the entry at qHead */
+static u_char qStep = 0;	/**< QUEUE_AREA: byte of CASET/PASET/RAMWR sequence */
+static u_char qLowDue = 0;	/**< a pixel's low byte (qLowByte) is next */
+static u_char qLowByte;
+static u_char qOdd = 0;		/**< QUEUE_INDEXED: next index is a low nibble */
+
+static const u_char areaCommands[3] = {CASETP, PASETP, RAMWRP};
+
+/** Next byte of a QUEUE_AREA entry: 5 for each of CASET and PASET
+ *  (the command and two 16 bit bounds) then RAMWR.  Sets *isData.
+ *  Returns with qStep at 0 after the last byte.
+ */
+static u_char
+areaByte(const QueueEntry *e, u_char *isData)
+{
+  u_char part, k, byte;
+  if (qStep == 0 && !(e->flags & QUEUE_CASET))
+    qStep = 5;
+  if (qStep == 5 && !(e->flags & QUEUE_PASET))
+    qStep = 10;
+  part = qStep / 5; k = qStep % 5;
+  *isData = (k != 0);
+  if (k == 0)
+    byte = areaCommands[part];
+  else if (k & 1)
+    byte = 0;			/**< high byte of a bound */
+  else
+    byte = e->u.window[2 * part + (k >> 2)];
+  qStep = (qStep == 10) ? 0 : qStep + 1;
+  return byte;
+}
+
+/** Send the next queued byte (TXBUF must be empty).
+ *  The transmit interrupt is disabled once the queue is empty.
+ */
+static void
+queueTx()
+{
+  QueueEntry *e = &queue[qHead];
+  u_char byte, isData = 1, done;
+  if (qLowDue) {		/**< second byte of a pixel */
+    byte = qLowByte;
+    qLowDue = 0;
+    done = !e->count;
+  } else if (e->op == QUEUE_AREA) {
+    byte = areaByte(e, &isData);
+    done = !qStep;
+  } else {
+    u_int colorBGR = e->u.colorBGR;
+    if (e->op == QUEUE_INDEXED) {
+      u_char index = *e->u.indexed.indices;
+      if (qOdd) {
+	index &= 0xf;
+	e->u.indexed.indices++;
+      } else
+	index >>= 4;
+      qOdd = !qOdd;
+      colorBGR = e->u.indexed.palette[index];
+    }
+    e->count--;
+    byte = colorBGR >> 8;
+    qLowByte = colorBGR;
+    qLowDue = 1;
+    done = 0;
+  }
+  if (isData != !!LCD_DC_IS_HI()) { /**< D/C may only change between bytes */
+#ifndef LCD_HOST
+    while (UCB0STAT & UCBUSY)
+      ;
+#endif
+    if (isData)
+      LCD_DC_HI();
+    else
+      LCD_DC_LO();
+  }
+  LCD_TX(byte);
+  if (done) {
+    qOdd = 0;
+    QUEUE_BARRIER();		/**< finished with the entry before releasing it */
+    qHead = (qHead + 1) & LCD_QUEUE_MASK;
+#ifndef LCD_HOST
+    if (qHead == qTail)
+      IE2 &= ~UCB0TXIE;
+#endif
+  }
+}
+
+#ifndef LCD_HOST
+void
+__interrupt_vec(USCIAB0TX_VECTOR) lcd_txInterrupt()
+{
+  queueTx();
+}
+#endif
+
+u_char lcd_queuePending()
+{
+  return (qTail - qHead) & LCD_QUEUE_MASK;
+}
+
+/** Wait until at most maxPending entries are unsent, sending them here
+ *  if interrupts are disabled (e.g. when called from an interrupt handler)
+ */
+void lcd_queueWait(u_char maxPending)
+{
+  while (lcd_queuePending() > maxPending)
+    if (!LCD_INTERRUPTS_ON()) {
+      LCD_WAIT_TXBUF();
+      queueTx();
+    }
+#ifndef LCD_HOST
+  if (!maxPending)
+    while (UCB0STAT & UCBUSY)	/**< last byte shifts out */
+      ;
+#endif
+}
+
+/** Slot for a new entry, waiting for one to be sent if the queue is full */
+static QueueEntry *
+queueReserve()
+{
+  lcd_queueWait(LCD_QUEUE_SIZE - 2);
+  return &queue[qTail];
+}
+
+/** Make the reserved entry visible to the transmit interrupt */
+static void
+queueCommit()
+{
+  QUEUE_BARRIER();		/**< entry is written before it is published */
+  qTail = (qTail + 1) & LCD_QUEUE_MASK;
+#ifdef LCD_HOST
+  lcd_queueWait(0);
+#else
+  IE2 |= UCB0TXIE;		/**< taken once interrupts are enabled */
+#endif
+}
+
+void lcd_queueArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd)
+{
+  QueueEntry *e;
+  if (transposed) {		/**< MADCTL is restored synchronously */
+    _writeCommand(MADCTL);
+    lcd_writeData(madctlValue);
+    transposed = 0;
+  }
+  LCD_STAT_ADD(setAreaCalls, 1);
+  e = queueReserve();
+  e->op = QUEUE_AREA;
+  e->flags = 0;
+  if (colStart != areaColStart || colEnd != areaColEnd) {
+    e->flags |= QUEUE_CASET;
+    areaColStart = colStart; areaColEnd = colEnd;
+    LCD_STAT_ADD(commandBytes, 1);
+    LCD_STAT_ADD(dataBytes, 4);
+  } else
+    LCD_STAT_ADD(addrBytesSaved, 5);
+  if (rowStart != areaRowStart || rowEnd != areaRowEnd) {
+    e->flags |= QUEUE_PASET;
+    areaRowStart = rowStart; areaRowEnd = rowEnd;
+    LCD_STAT_ADD(commandBytes, 1);
+    LCD_STAT_ADD(dataBytes, 4);
+  } else
+    LCD_STAT_ADD(addrBytesSaved, 5);
+  LCD_STAT_ADD(commandBytes, 1);
+  e->u.window[0] = colStart; e->u.window[1] = colEnd;
+  e->u.window[2] = rowStart; e->u.window[3] = rowEnd;
+  ramwrOpen = 1;		/**< once the queue reaches RAMWR */
+  areaSerial++;
+  queueCommit();
+}
+
+void lcd_queueRun(u_int colorBGR, u_int count)
+{
+  QueueEntry *e;
+  if (!count)
+    return;
+  LCD_STAT_ADD(pixels, count);
+  LCD_STAT_ADD(dataBytes, 2L * count);
+  e = queueReserve();
+  e->op = QUEUE_RUN;
+  e->u.colorBGR = colorBGR;
+  e->count = count;
+  queueCommit();
+}
+
+void lcd_writeIndexed(const u_char *indices, u_char count, const u_int *palette)
+{
+  QueueEntry *e;
+  if (!count)
+    return;
+  LCD_STAT_ADD(pixels, count);
+  LCD_STAT_ADD(dataBytes, 2L * count);
+  e = queueReserve();
+  e->op = QUEUE_INDEXED;
+  e->u.indexed.indices = indices;
+  e->u.indexed.palette = palette;
+  e->count = count;
+  queueCommit();
+}
+
+#endif /* LCD_COLOR12 */
+
+u_char lcd_scrollTop = 0, lcd_scrollRows = screenHeight, lcd_scrollOffset = 0;
+
+#ifdef LCD_CAN_SCROLL
+
+/** Write a 16 bit parameter (private) */
+static void
+writeData16(u_int value)
+{
+  lcd_writeData(value >> 8);
+  lcd_writeData(value);
+}
+
+/** The panel's scroll registers address frame memory lines, which run
+ *  bottom to top when MADCTL's MY bit is set; the fixed bands and the
+ *  scroll direction are mirrored to match.
+ */
+void lcd_scrollDefine(u_char topFixed, u_char bottomFixed)
+{
+  lcd_scrollTop = topFixed;
+  lcd_scrollRows = screenHeight - topFixed - bottomFixed;
+  _writeCommand(VSCRDEF);
+  writeData16((madctlValue & MADCTL_MY) ? bottomFixed : topFixed);
+  writeData16(lcd_scrollRows);
+  writeData16((madctlValue & MADCTL_MY) ? topFixed : bottomFixed);
+  lcd_scrollTo(0);
+}
+
+void lcd_scrollTo(u_char offset)
+{
+  u_int startLine;		/**< memory line shown at the top of the area */
+  lcd_scrollOffset = offset;
+  if (madctlValue & MADCTL_MY)
+    startLine = (screenHeight - lcd_scrollTop - lcd_scrollRows)
+      + (offset ? lcd_scrollRows - offset : 0);
+  else
+    startLine = lcd_scrollTop + offset;
+  _writeCommand(VSCRSACC);
+  writeData16(startLine);
+}
+
+#endif /* LCD_CAN_SCROLL */
+
+u_char lcd_scrollRow(u_char row)
+{
+  u_int mapped;
+  if (row < lcd_scrollTop || row >= lcd_scrollTop + lcd_scrollRows)
+    return row;
+  mapped = row + lcd_scrollOffset;
+  if (mapped >= lcd_scrollTop + lcd_scrollRows)
+    mapped -= lcd_scrollRows;
+  return mapped;
 }
 
 /** Initialize onboard LCD */
 void lcd_init() 
 {
   setUpSPIforLCD();
-  _writeCommand(SWRESET);  /**< software reset */
+  lcd_invalidateArea();
+  _writeCommand(SWRESET);  /**< software reset (also ends scrolling) */
+  lcd_scrollTop = lcd_scrollOffset = 0;
+  lcd_scrollRows = screenHeight;
   _delay(20);
   _writeCommand(SLEEPOUT); /**< exit sleep */
   _delay(20);
-  _writeCommand(COLMOD);   /**< Set Color Format 16bit */
-  lcd_writeData(0x05);
+  _writeCommand(COLMOD);   /**< Set Color Format (16 or 12 bit) */
+  lcd_writeData(LCD_COLMOD);
   _writeCommand(DISPON);   /**< display ON */
 
-  _writeCommand(MADCTL);
   switch (ORIENTATION) {
   case ORIENTATION_HORIZONTAL:
-    lcd_writeData(0x68);
+    madctlValue = 0x68;
     break;
   case ORIENTATION_VERTICAL_ROTATED:
-    lcd_writeData(0x08);
+    madctlValue = 0x08;
     break;
   case ORIENTATION_HORIZONTAL_ROTATED:
-    lcd_writeData(0xA8);
+    madctlValue = 0xA8;
     break;
   default:
-    lcd_writeData(0xC8);
+    madctlValue = 0xC8;
   }
+  _writeCommand(MADCTL);
+  lcd_writeData(madctlValue);
+  transposed = 0;
 }
-
@@ -0,0 +1,181 @@
+///////////////////////////////////////////
+// makeRLE: convert a PPM image into an RleBitmap (see lcddraw.h)
+//
+// usage: makeRLE image.ppm name [rrggbb]
+//   writes name.c (the encoded image and "const RleBitmap name") and
+//   name.h.  Pixels of color rrggbb (hex) are transparent.
+///////////////////////////////////////////
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "ctype.h"
+#include "assert.h"
+
+#define RLE_LITERAL 0x0000	/* as in lcddraw.h */
+#define RLE_RUN     0x4000
+#define RLE_SKIP    0x8000
+
+#define TRANSPARENT (-1)	/* pixel value of the key color */
+
+// skip white space and comments, then read an unsigned header field
+static int readNumber(FILE *fp)
+{
+  int c, n = 0;
+  while ((c = getc(fp)) != EOF && (isspace(c) || c == '#'))
+    if (c == '#')
+      while ((c = getc(fp)) != EOF && c != '\n')
+	;
+  if (!isdigit(c)) {
+    fprintf(stderr, "makeRLE: malformed or truncated image\n");
+    exit(1);
+  }
+  for (; isdigit(c); c = getc(fp))
+    n = n * 10 + (c - '0');
+  return n;
+}
+
+// read one sample scaled to 0..255 (raw samples use 1 or 2 bytes)
+static int readSample(FILE *fp, int raw, int maxVal)
+{
+  int c;
+  if (!raw)
+    c = readNumber(fp);
+  else {
+    c = getc(fp);
+    if (maxVal > 255)
+      c = (c << 8) | getc(fp);
+    if (feof(fp)) {
+      fprintf(stderr, "makeRLE: truncated image\n");
+      exit(1);
+    }
+  }
+  return c * 255 / maxVal;
+}
+
+// 8 bit rgb to the LCD's 5-6-5 bgr
+static int bgr565(int r, int g, int b)
+{
+  return ((b >> 3) << 11) | ((g >> 2) << 5) | (r >> 3);
+}
+
+// number of pixels from x equal to row[x] (at most 255)
+static int runLength(const int *row, int x, int width)
+{
+  int n = 1;
+  while (x + n < width && row[x + n] == row[x] && n < 255)
+    n++;
+  return n;
+}
+
+static FILE *out;
+static int words = 0;
+
+static void emit(const char *s, int value)
+{
+  fprintf(out, s, value);
+  words++;
+}
+
+/* Encode one row.  Same-color runs of at least 3 pixels become
+ * RLE_RUN (2 words); shorter ones join a literal (1 word per pixel
+ * plus 1 for the literal's opcode).
+ */
+static void encodeRow(const int *row, int width)
+{
+  int x = 0;
+  while (x < width) {
+    int n = runLength(row, x, width), i;
+    if (row[x] == TRANSPARENT) {
+      emit(" RLE_SKIP|%d,", n);
+    } else if (n >= 3) {
+      emit(" RLE_RUN|%d,", n);
+      emit(" LCD_COLOR(0x%04x),", row[x]);
+    } else {			/* literal until a run or transparency */
+      for (n = 0; x + n < width && row[x + n] != TRANSPARENT
+	     && runLength(row, x + n, width) < 3 && n < 255; )
+	n += runLength(row, x + n, width);
+      if (n > 255)
+	n = 255;
+      emit(" RLE_LITERAL|%d,", n);
+      for (i = 0; i < n; i++)
+	emit(" LCD_COLOR(0x%04x),", row[x + i]);
+    }
+    x += n;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  int width, height, maxVal, raw, row, col, key = TRANSPARENT;
+  int *pixels;
+  char filename[100];
+  FILE *in;
+
+  if (argc != 3 && argc != 4) {
+    fprintf(stderr, "usage: makeRLE image.ppm name [transparent rrggbb]\n");
+    return 1;
+  }
+  if (argc == 4) {
+    int rgb = strtol(argv[3], 0, 16);
+    key = bgr565(rgb >> 16 & 0xff, rgb >> 8 & 0xff, rgb & 0xff);
+  }
+  in = fopen(argv[1], "rb");
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+  if (getc(in) != 'P' || ((raw = getc(in)) != '3' && raw != '6')) {
+    fprintf(stderr, "makeRLE: %s is not a PPM image\n", argv[1]);
+    return 1;
+  }
+  raw = raw == '6';
+  width = readNumber(in);
+  height = readNumber(in);
+  maxVal = readNumber(in);	/* followed by a single white space */
+  if (width < 1 || width > 255 || height < 1 || height > 255 || maxVal < 1) {
+    fprintf(stderr, "makeRLE: images are at most 255x255 pixels\n");
+    return 1;
+  }
+
+  pixels = malloc(sizeof(int) * width * height);
+  assert(pixels);
+  for (row = 0; row < height; row++)
+    for (col = 0; col < width; col++) {
+      int r = readSample(in, raw, maxVal);
+      int g = readSample(in, raw, maxVal);
+      int b = readSample(in, raw, maxVal);
+      int color = bgr565(r, g, b);
+      pixels[row * width + col] = (color == key) ? TRANSPARENT : color;
+    }
+  fclose(in);
+
+  sprintf(filename, "%.90s.c", argv[2]);
+  out = fopen(filename, "w");
+  assert(out);
+  fprintf(out, "// Automatically generated by makeRLE from %s\n", argv[1]);
+  fprintf(out, "#include \"%s.h\"\n\n", argv[2]);
+  fprintf(out, "static const u_int %sData[] = {\n", argv[2]);
+  for (row = 0; row < height; row++) {
+    fprintf(out, "  /* row %d */", row);
+    encodeRow(pixels + row * width, width);
+    fprintf(out, "\n");
+  }
+  fprintf(out, "};\n\n");
+  fprintf(out, "const RleBitmap %s = {%d, %d, %sData};\n", argv[2], width, height, argv[2]);
+  fclose(out);
+
+  sprintf(filename, "%.90s.h", argv[2]);
+  out = fopen(filename, "w");
+  assert(out);
+  fprintf(out, "// Automatically generated by makeRLE from %s\n", argv[1]);
+  fprintf(out, "#ifndef %s_included\n#define %s_included\n\n", argv[2], argv[2]);
+  fprintf(out, "#include \"lcdutils.h\"\n#include \"lcddraw.h\"\n\n");
+  fprintf(out, "extern const RleBitmap %s;\n", argv[2]);
+  fprintf(out, "\n#endif // included\n");
+  fclose(out);
+
+  printf("%s: %dx%d pixels, %d bytes (%d uncompressed)\n",
+	 argv[2], width, height, 2 * words, 2 * width * height);
+  free(pixels);
+  return 0;
+}
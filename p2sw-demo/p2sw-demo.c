@@ -7,25 +7,48 @@
 #include <lcddraw.h>
 #include <p2switches.h>
 
+static Event switchEventBuf[8];
+EventRing switchEvents = EVENT_RING_INIT(switchEventBuf);
 
-/** Initializes everything, clears the screen, draws "hello" and the circle */
+/** Initializes everything, then shows the switches and counts presses
+ *  as their events arrive
+ */
 void main()
 {
   configureClocks();
   lcd_init();
   p2sw_init(15);
+  p2sw_postEvents(&switchEvents);
   or_sr(0x8);			/* GIE (enable interrupts) */
   u_char width = screenWidth, height = screenHeight;
 
   clearScreen(COLOR_BLUE);
 
   drawString5x7(10,10, "switches:", COLOR_GREEN, COLOR_BLUE);
+  drawString5x7(10,40, "presses:", COLOR_GREEN, COLOR_BLUE);
   while (1) {
-    u_int switches = p2sw_read(), i;
-    char str[5];
-    for (i = 0; i < 4; i++)
-      str[i] = (switches & (1<<i)) ? '-' : '0'+i;
-    str[4] = 0;
-    drawString5x7(20,20, str, COLOR_GREEN, COLOR_BLUE);
+    static u_int presses = 0;
+    Event event;
+    u_int i, n;
+    char str[6];
+    and_sr(~8);			/* GIE off: no event can slip in before sleeping */
+    if (!eventCount(&switchEvents)) {
+      or_sr(0x18);		/* CPU off, GIE on; a switch event wakes us */
+      continue;
+    }
+    or_sr(8);
+    while (eventGet(&switchEvents, &event)) { /* every change, in order */
+      for (i = 0; i < 4; i++) {
+	str[i] = (event.data & (1<<i)) ? '-' : '0'+i;
+	if ((event.type & (1<<i)) && !(event.data & (1<<i)))
+	  presses++;		/* switch i went down */
+      }
+      str[4] = 0;
+      drawString5x7(20,20, str, COLOR_GREEN, COLOR_BLUE);
+    }
+    for (i = 5, n = presses; i-- > 0; n /= 10)
+      str[i] = '0' + n % 10;
+    str[5] = 0;
+    drawString5x7(20,50, str, COLOR_GREEN, COLOR_BLUE);
   } 
 }
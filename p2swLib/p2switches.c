@@ -5,6 +5,8 @@ static unsigned char switch_mask;
 static unsigned char switches_last_reported;
 static unsigned char switches_current;
 
+static EventRing *switch_events;	/* 0: changes are not posted */
+
 static void
 switch_update_interrupt_sense()
 {
@@ -37,12 +39,22 @@ p2sw_read() {
   return switches_current | (sw_changed << 8);
 }
 
+void
+p2sw_postEvents(EventRing *events)
+{
+  switch_events = events;
+}
+
 /* Switch on P2 (S1) */
 void
 __interrupt_vec(PORT2_VECTOR) Port_2(){
   if (P2IFG & switch_mask) {  /* did a button cause this interrupt? */
+    unsigned char switches_before = switches_current;
     P2IFG &= ~switch_mask;	/* clear pending sw interrupts */
     switch_update_interrupt_sense();
-    //change color
+    if (switches_current != switches_before && switch_events) {
+      eventPost(switch_events, switches_current ^ switches_before, switches_current);
+      __bic_SR_register_on_exit(CPUOFF); /* let main read it */
+    }
   }
 }
@@ -2,8 +2,17 @@
 #define switches_included
 
 #include "msp430.h"
+#include "eventRing.h"
 
 unsigned int p2sw_read();
 void p2sw_init(unsigned char mask);
 
+/* Post every change of the switches to events (0 to stop):
+ * type is the switches that changed, data is the state of all of them
+ * (as in p2sw_read's low byte).  Posting wakes the CPU.  The program
+ * supplies the ring, so programs that only poll p2sw_read spend no
+ * RAM on events.
+ */
+void p2sw_postEvents(EventRing *events);
+
 #endif // included
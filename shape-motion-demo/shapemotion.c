@@ -17,16 +17,16 @@
 #define GREEN_LED BIT6
 
 
-AbRect rect10 = {abRectGetBounds, abRectCheck, {10,10}}; /**< 10x10 rectangle */
-AbRArrow rightArrow = {abRArrowGetBounds, abRArrowCheck, 30};
+const AbRect rect10 = {abRectGetBounds, abRectCheck, {10,10}}; /**< 10x10 rectangle */
+const AbRArrow rightArrow = {abRArrowGetBounds, abRArrowCheck, 30};
 
-AbRectOutline fieldOutline = {	/* playing field */
+const AbRectOutline fieldOutline = {	/* playing field */
   abRectOutlineGetBounds, abRectOutlineCheck,   
   {screenWidth/2 - 10, screenHeight/2 - 10}
 };
 
 Layer layer4 = {
-  (AbShape *)&rightArrow,
+  (const AbShape *)&rightArrow,
   {(screenWidth/2)+10, (screenHeight/2)+5}, /**< bit below & right of center */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_PINK,
@@ -35,7 +35,7 @@ Layer layer4 = {
   
 
 Layer layer3 = {		/**< Layer with an orange circle */
-  (AbShape *)&circle8,
+  (const AbShape *)&circle8,
   {(screenWidth/2)+10, (screenHeight/2)+5}, /**< bit below & right of center */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_VIOLET,
@@ -44,7 +44,7 @@ Layer layer3 = {		/**< Layer with an orange circle */
 
 
 Layer fieldLayer = {		/* playing field as a layer */
-  (AbShape *) &fieldOutline,
+  (const AbShape *) &fieldOutline,
   {screenWidth/2, screenHeight/2},/**< center */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_BLACK,
@@ -52,7 +52,7 @@ Layer fieldLayer = {		/* playing field as a layer */
 };
 
 Layer layer1 = {		/**< Layer with a red square */
-  (AbShape *)&rect10,
+  (const AbShape *)&rect10,
   {screenWidth/2, screenHeight/2}, /**< center */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_RED,
@@ -60,99 +60,60 @@ Layer layer1 = {		/**< Layer with a red square */
 };
 
 Layer layer0 = {		/**< Layer with an orange circle */
-  (AbShape *)&circle14,
+  (const AbShape *)&circle14,
   {(screenWidth/2)+10, (screenHeight/2)+5}, /**< bit below & right of center */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_ORANGE,
   &layer1,
 };
 
-/** Moving Layer
- *  Linked list of layer references
- *  Velocity represents one iteration of change (direction & magnitude)
+/** Moving layers (see Motion in shape.h)
+ *  Velocities are Q8.8 pixels per 16ms motion tick: Q8_8(1)/4 is
+ *  about 16 pixels/sec.
  */
-typedef struct MovLayer_s {
-  Layer *layer;
-  Vec2 velocity;
-  struct MovLayer_s *next;
-} MovLayer;
-
-/* initial value of {0,0} will be overwritten */
-MovLayer ml3 = { &layer3, {1,1}, 0 }; /**< not all layers move */
-MovLayer ml1 = { &layer1, {1,2}, &ml3 }; 
-MovLayer ml0 = { &layer0, {2,1}, &ml1 }; 
-
-void movLayerDraw(MovLayer *movLayers, Layer *layers)
+Motion ml3 = { &layer3, {66,66}, {0,0}, 0, {0,0}, 0 }; /**< not all layers move */
+Motion ml1 = { &layer1, {66,133}, {0,0}, 0, {0,0}, &ml3 }; 
+Motion ml0 = { &layer0, {133,66}, {0,0}, 0, {0,0}, &ml1 }; 
+
+void movLayerDraw(Motion *movLayers, Layer *layers)
 {
-  int row, col;
-  MovLayer *movLayer;
+  Motion *movLayer;
 
   and_sr(~8);			/**< disable interrupts (GIE off) */
   for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
     Layer *l = movLayer->layer;
-    l->posLast = l->pos;
     l->pos = l->posNext;
   }
   or_sr(8);			/**< disable interrupts (GIE on) */
 
-
-  for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
-    Region bounds;
-    layerGetBounds(movLayer->layer, &bounds);
-    lcd_setArea(bounds.topLeft.axes[0], bounds.topLeft.axes[1], 
-		bounds.botRight.axes[0], bounds.botRight.axes[1]);
-    for (row = bounds.topLeft.axes[1]; row <= bounds.botRight.axes[1]; row++) {
-      for (col = bounds.topLeft.axes[0]; col <= bounds.botRight.axes[0]; col++) {
-	Vec2 pixelPos = {col, row};
-	u_int color = bgColor;
-	Layer *probeLayer;
-	for (probeLayer = layers; probeLayer; 
-	     probeLayer = probeLayer->next) { /* probe all layers, in order */
-	  if (abShapeCheck(probeLayer->abShape, &probeLayer->pos, &pixelPos)) {
-	    color = probeLayer->color;
-	    break; 
-	  } /* if probe check */
-	} // for checking all layers at col, row
-	lcd_writeColor(color); 
-      } // for col
-    } // for row
-  } // for moving layer being updated
+  layerRedrawDirty(layers);	/**< repaint where layers left and arrived */
 }	  
 
 
+u_int bgColor = COLOR_BLUE;     /**< The background color */
 
-//Region fence = {{10,30}, {SHORT_EDGE_PIXELS-10, LONG_EDGE_PIXELS-10}}; /**< Create a fence region */
-
-/** Advances a moving shape within a fence
- *  
- *  \param ml The moving shape to be advanced
- *  \param fence The region which will serve as a boundary for ml
- */
-void mlAdvance(MovLayer *ml, Region *fence)
-{
-  Vec2 newPos;
-  u_char axis;
-  Region shapeBoundary;
-  for (; ml; ml = ml->next) {
-    vec2Add(&newPos, &ml->layer->posNext, &ml->velocity);
-    abShapeGetBounds(ml->layer->abShape, &newPos, &shapeBoundary);
-    for (axis = 0; axis < 2; axis ++) {
-      if ((shapeBoundary.topLeft.axes[axis] < fence->topLeft.axes[axis]) ||
-	  (shapeBoundary.botRight.axes[axis] > fence->botRight.axes[axis]) ) {
-	int velocity = ml->velocity.axes[axis] = -ml->velocity.axes[axis];
-	newPos.axes[axis] += (2*velocity);
-      }	/**< if outside of fence */
-    } /**< for axis */
-    ml->layer->posNext = newPos;
-  } /**< for ml */
-}
-
+u_char scanlines[2 * 16];	/**< two 32 pixel rows of indices */
+u_int palette[6];		/**< bgColor and the five layers' colors */
 
-u_int bgColor = COLOR_BLUE;     /**< The background color */
 int redrawScreen = 1;           /**< Boolean for whether screen needs to be redrawn */
 
 Region fieldFence;		/**< fence around playing field  */
 
+int motionTick(SoftTimer *timer);
+SoftTimer motionTimer = { motionTick, 16 }; /**< every 16ms */
+volatile u_char motionTicks = 0; /**< ticks main has yet to advance the layers for */
+
+#ifdef LCD_STATS
+LcdStats frameStats;		/**< LCD cost of the last frame (view in debugger) */
+LayerStats frameLayerStats;	/**< pixels painted vs changed in the last frame */
+#endif
+
+/** Profile probes (build with -DPROFILE and view profileProbes) */
+enum { PROBE_LAYER_DRAW, PROBE_MOV_LAYER_DRAW, PROBE_MOTION_ADVANCE };
+#ifdef PROFILE
+u_int switchIsrCycles;		/**< cost of a switch interrupt (isr.h) */
+#endif
+
 
 /** Initializes everything, enables interrupts and green LED, 
  *  and handles the rendering for the screen
@@ -162,46 +123,69 @@ void main()
   P1DIR |= GREEN_LED;		/**< Green led on when CPU on */		
   P1OUT |= GREEN_LED;
 
-  configureClocks();
+  configureClocksProfile(CLOCKS_SMCLK_8MHZ); /**< 8MHz SPI */
   lcd_init();
   shapeInit();
+  abCircleInit();
   p2sw_init(1);
 
   shapeInit();
 
+  layerUseScanlines(scanlines, 32, palette, 6);
   layerInit(&layer0);
+  softTimerInit();
+#ifdef PROFILE
+  profileInit();		/**< after softTimerInit: shares Timer A1 */
+#endif
+  or_sr(0x8);	              /**< GIE (enable interrupts) */
+#ifdef PROFILE
+  switchIsrCycles = isrInterruptCycles(&P2IFG, BIT0);
+#endif
+  PROFILE_BEGIN(PROBE_LAYER_DRAW);
   layerDraw(&layer0);
+  PROFILE_END(PROBE_LAYER_DRAW);
 
 
   layerGetBounds(&fieldLayer, &fieldFence);
 
 
-  enableWDTInterrupts();      /**< enable periodic interrupt */
-  or_sr(0x8);	              /**< GIE (enable interrupts) */
+  softTimerStart(&motionTimer, 16); /**< periodic interrupt */
 
 
   for(;;) { 
-    while (!redrawScreen) { /**< Pause CPU if screen doesn't need updating */
+    while (!motionTicks) {    /**< Pause CPU until the layers are due to move */
       P1OUT &= ~GREEN_LED;    /**< Green led off witHo CPU */
       or_sr(0x10);	      /**< CPU OFF */
     }
     P1OUT |= GREEN_LED;       /**< Green led on when CPU on */
+    and_sr(~8);
+    motionTicks--;
+    or_sr(8);
+    PROFILE_BEGIN(PROBE_MOTION_ADVANCE);
+    if (motionAdvance(&ml0, &fieldFence) && p2sw_read())
+      redrawScreen = 1;
+    PROFILE_END(PROBE_MOTION_ADVANCE);
+    if (!redrawScreen)
+      continue;
     redrawScreen = 0;
+    PROFILE_BEGIN(PROBE_MOV_LAYER_DRAW);
     movLayerDraw(&ml0, &layer0);
+    PROFILE_END(PROBE_MOV_LAYER_DRAW);
+#ifdef LCD_STATS
+    lcd_statsSnapshot(&frameStats);
+    lcd_statsReset();
+    layerStatsSnapshot(&frameLayerStats);
+    layerStatsReset();
+#endif
   }
 }
 
-/** Watchdog timer interrupt handler. 15 interrupts/sec */
-void wdt_c_handler()
+/** Motion timer callback, every 16ms.  Main advances the layers a
+ *  fraction of a pixel each time, and redraws the screen when one
+ *  reaches a new pixel.
+ */
+int motionTick(SoftTimer *timer)
 {
-  static short count = 0;
-  P1OUT |= GREEN_LED;		      /**< Green LED on when cpu on */
-  count ++;
-  if (count == 15) {
-    mlAdvance(&ml0, &fieldFence);
-    if (p2sw_read())
-      redrawScreen = 1;
-    count = 0;
-  } 
-  P1OUT &= ~GREEN_LED;		    /**< Green LED off when cpu off */
+  motionTicks++;
+  return 1;			    /**< wake main to advance the layers */
 }
@@ -0,0 +1,219 @@
+#include "lcdutils.h"
+#include "shape.h"
+#include "dirty.h"
+
+/** Dirty rectangles are merged when that paints at most this many
+ *  extra pixels (about the cost of setting up another window).
+ */
+#define LAYER_MERGE_SLACK 16
+
+long
+regionArea(const Region *r)
+{
+  int width = r->botRight.axes[0] - r->topLeft.axes[0] + 1;
+  int height = r->botRight.axes[1] - r->topLeft.axes[1] + 1;
+  if (width <= 0 || height <= 0)
+    return 0;
+  return (long)width * height;
+}
+
+/** Computes the intersection of two regions (empty if they do not overlap) */
+static void
+regionIntersect(Region *rIntersect, const Region *r1, const Region *r2)
+{
+  vec2Max(&rIntersect->topLeft, &r1->topLeft, &r2->topLeft);
+  vec2Min(&rIntersect->botRight, &r1->botRight, &r2->botRight);
+}
+
+/** True if the bounding box of r and dirty (stored in merged) adds
+ *  at most LAYER_MERGE_SLACK pixels to the area they cover
+ */
+static int
+mergeFits(const Region *r, const Region *dirty, Region *merged)
+{
+  Region overlap;
+  regionUnion(merged, r, dirty);
+  regionIntersect(&overlap, r, dirty);
+  return regionArea(merged) - regionArea(r) - regionArea(dirty) + regionArea(&overlap)
+    <= LAYER_MERGE_SLACK;
+}
+
+/** True if r1 and r2 share a pixel */
+static int
+regionsOverlap(const Region *r1, const Region *r2)
+{
+  int axis;
+  for (axis = 0; axis < 2; axis++)
+    if (r1->topLeft.axes[axis] > r2->botRight.axes[axis]
+	|| r2->topLeft.axes[axis] > r1->botRight.axes[axis])
+      return 0;
+  return 1;
+}
+
+/** Replace dirty[i] by its union with r, absorbing any other dirty
+ *  rectangles the union overlaps.  Returns the new count.
+ */
+static int
+dirtyAbsorb(Region dirty[], int numDirty, int i, const Region *r)
+{
+  Region merged;
+  regionUnion(&merged, r, &dirty[i]);
+  dirty[i] = dirty[--numDirty];
+  for (i = 0; i < numDirty; i++) {
+    if (regionsOverlap(&merged, &dirty[i])) {
+      regionUnion(&merged, &merged, &dirty[i]);
+      dirty[i] = dirty[--numDirty];
+      i = -1;			/* the union grew: check all again */
+    }
+  }
+  dirty[numDirty++] = merged;
+  return numDirty;
+}
+
+/** Add r to the disjoint dirty rectangles, returning their new count.
+ *
+ *  r is merged with a dirty rectangle it overlaps, or whose bounding
+ *  box with r adds little area, so no pixel is painted twice.
+ *  Otherwise r is kept apart.  When rectangles run out, r grows the
+ *  dirty rectangle it adds the least area to instead.
+ */
+static int
+dirtyAdd(Region dirty[], int numDirty, const Region *r)
+{
+  Region merged;
+  int i, best = 0;
+  long bestGrowth = 0;
+  if (!regionArea(r))
+    return numDirty;
+  for (i = 0; i < numDirty; i++)
+    if (regionsOverlap(r, &dirty[i]) || mergeFits(r, &dirty[i], &merged))
+      return dirtyAbsorb(dirty, numDirty, i, r);
+  if (numDirty < LAYER_MAX_DIRTY) {
+    dirty[numDirty] = *r;
+    return numDirty + 1;
+  }
+  for (i = 0; i < numDirty; i++) { /* out of room: grow the cheapest */
+    long growth;
+    regionUnion(&merged, r, &dirty[i]);
+    growth = regionArea(&merged) - regionArea(&dirty[i]);
+    if (!i || growth < bestGrowth) {
+      best = i;
+      bestGrowth = growth;
+    }
+  }
+  return dirtyAbsorb(dirty, numDirty, best, r);
+}
+
+/** Bounds of l at pos, clipped to the visible rows of the screen */
+static void
+layerVisibleBounds(const Layer *l, const Vec2 *pos, Region *bounds)
+{
+  int rowMin = lcd_scrollTop + layerScrollPos, rowMax = rowMin + lcd_scrollRows - 1;
+  abShapeGetBounds(l->abShape, pos, bounds);
+  if (bounds->topLeft.axes[0] < 0) bounds->topLeft.axes[0] = 0;
+  if (bounds->topLeft.axes[1] < rowMin) bounds->topLeft.axes[1] = rowMin;
+  if (bounds->botRight.axes[0] > screenWidth-1) bounds->botRight.axes[0] = screenWidth-1;
+  if (bounds->botRight.axes[1] > rowMax) bounds->botRight.axes[1] = rowMax;
+}
+
+/** Grow region r to include cols colMin..colMax of row */
+static void
+regionGrow(Region *r, int colMin, int colMax, int row)
+{
+  if (r->topLeft.axes[0] > r->botRight.axes[0]) { /* empty */
+    r->topLeft.axes[0] = colMin; r->botRight.axes[0] = colMax;
+    r->topLeft.axes[1] = r->botRight.axes[1] = row;
+    return;
+  }
+  if (colMin < r->topLeft.axes[0]) r->topLeft.axes[0] = colMin;
+  if (colMax > r->botRight.axes[0]) r->botRight.axes[0] = colMax;
+  if (row < r->topLeft.axes[1]) r->topLeft.axes[1] = row;
+  if (row > r->botRight.axes[1]) r->botRight.axes[1] = row;
+}
+
+/** Strips containing the pixels a layer's shape covers at only one of
+ *  posLast and pos.
+ *
+ *  Rows covered at only one position form the top and bottom strips;
+ *  in rows covered at both, the spans' differing ends form the left
+ *  and right strips.  A paddle moving sideways thus repaints a few
+ *  columns at each end rather than its whole bounding box.
+ *
+ *  Returns 0 if the shape does not have a single span in every row,
+ *  or if the strips would not be smaller than the old and new bounds.
+ */
+static int
+layerMotionStrips(const Layer *l, Region strips[4])
+{
+  Span spans[1 + ABSHAPE_MAX_SPANS]; /* the old span, then the new row's query */
+  Span *oldSpan = &spans[0], *newSpan = &spans[1];
+  int row, rowMin, rowMax, i, bothSeen = 0;
+  long stripsArea = 0, boundsArea;
+  {
+    Region oldBounds, newBounds, overlap;
+    layerVisibleBounds(l, &l->posLast, &oldBounds);
+    layerVisibleBounds(l, &l->pos, &newBounds);
+    rowMin = oldBounds.topLeft.axes[1] < newBounds.topLeft.axes[1]
+      ? oldBounds.topLeft.axes[1] : newBounds.topLeft.axes[1];
+    rowMax = oldBounds.botRight.axes[1] > newBounds.botRight.axes[1]
+      ? oldBounds.botRight.axes[1] : newBounds.botRight.axes[1];
+    regionIntersect(&overlap, &oldBounds, &newBounds);
+    boundsArea = regionArea(&oldBounds) + regionArea(&newBounds) - regionArea(&overlap);
+  }
+  for (i = 0; i < 4; i++) {	/* top, bottom, left, right: empty */
+    strips[i].topLeft.axes[0] = 1;
+    strips[i].botRight.axes[0] = 0;
+  }
+  for (row = rowMin; row <= rowMax; row++) {
+    int numOld = abShapeRowSpans(l->abShape, &l->posLast, row, oldSpan), numNew;
+    if (numOld < 0 || numOld > 1)
+      return 0;			/* uncertain: use the bounds */
+    numNew = abShapeRowSpans(l->abShape, &l->pos, row, newSpan);
+    if (numNew < 0 || numNew > 1)
+      return 0;
+    if (!numOld && !numNew)
+      continue;
+    if (numOld && numNew && oldSpan[0].colMin <= newSpan[0].colMax
+	&& newSpan[0].colMin <= oldSpan[0].colMax) { /* spans overlap */
+      Span *left = oldSpan[0].colMin < newSpan[0].colMin ? oldSpan : newSpan;
+      Span *right = oldSpan[0].colMax > newSpan[0].colMax ? oldSpan : newSpan;
+      bothSeen = 1;
+      if (oldSpan[0].colMin != newSpan[0].colMin)
+	regionGrow(&strips[2], left->colMin, (left == oldSpan ? newSpan : oldSpan)->colMin - 1, row);
+      if (oldSpan[0].colMax != newSpan[0].colMax)
+	regionGrow(&strips[3], (right == oldSpan ? newSpan : oldSpan)->colMax + 1, right->colMax, row);
+      continue;
+    }
+    for (i = 0; i < numOld + numNew; i++) { /* row differs entirely */
+      Span *span = (i < numOld) ? oldSpan : newSpan;
+      regionGrow(&strips[bothSeen], span->colMin, span->colMax, row);
+    }
+  }
+  for (i = 0; i < 4; i++) {	/* spans are not clipped to the screen */
+    if (strips[i].topLeft.axes[0] < 0) strips[i].topLeft.axes[0] = 0;
+    if (strips[i].botRight.axes[0] > screenWidth-1) strips[i].botRight.axes[0] = screenWidth-1;
+    stripsArea += regionArea(&strips[i]);
+  }
+  return stripsArea < boundsArea;
+}
+
+int
+layerDirtyRects(Layer *layers, Region dirty[])
+{
+  Region strips[4];
+  int numDirty = 0, i;
+  Layer *l;
+  for (l = layers; l; l = l->next) {
+    if (l->pos.axes[0] == l->posLast.axes[0] && l->pos.axes[1] == l->posLast.axes[1])
+      continue;
+    if (!layerMotionStrips(l, strips)) { /* the old and new bounds instead */
+      layerVisibleBounds(l, &l->posLast, &strips[0]);
+      layerVisibleBounds(l, &l->pos, &strips[1]);
+      strips[2].topLeft.axes[0] = strips[3].topLeft.axes[0] = 1; /* empty */
+      strips[2].botRight.axes[0] = strips[3].botRight.axes[0] = 0;
+    }
+    for (i = 0; i < 4; i++)
+      numDirty = dirtyAdd(dirty, numDirty, &strips[i]);
+  }
+  return numDirty;
+}
@@ -0,0 +1,25 @@
+/** \file dirty.h
+ *  \brief Dirty rectangles for layerRedrawDirty
+ *
+ *  Kept apart from layer.c so that the work of finding what changed
+ *  is off the stack while the changes are drawn.  Internal to shapeLib.
+ */
+
+#ifndef dirty_included
+#define dirty_included
+
+#include "shape.h"
+
+/** Dirty rectangles kept by layerRedrawDirty */
+#define LAYER_MAX_DIRTY 3
+
+/** Pixels in r (0 if it is empty) */
+long regionArea(const Region *r);
+
+/** Store in dirty the disjoint rectangles that cover the pixels
+ *  changed by layers that moved (see layerRedrawDirty).
+ *  Returns their number, at most LAYER_MAX_DIRTY.
+ */
+int layerDirtyRects(Layer *layers, Region dirty[]);
+
+#endif // included
@@ -1,28 +1,448 @@
 #include "lcdutils.h"
 #include "lcddraw.h"
 #include "shape.h"
+#include "shapeSpans.h"
+#include "dirty.h"
+
+/** Probe a layer without a span query at col, row.
+ *
+ *  Returns 1 if it covers the pixel, otherwise 0, after pulling
+ *  *runEnd in to the first column at which its coverage may change
+ *  (single pixels within its bounds).
+ */
+static int
+layerProbe(const Layer *l, const Vec2 *pos, int row, int col, int *runEnd)
+{
+  Region bounds;
+  abShapeGetBounds(l->abShape, pos, &bounds);
+  if (row < bounds.topLeft.axes[1] || row > bounds.botRight.axes[1] ||
+      col > bounds.botRight.axes[0])
+    return 0;
+  if (col < bounds.topLeft.axes[0]) {
+    if (*runEnd >= bounds.topLeft.axes[0])
+      *runEnd = bounds.topLeft.axes[0] - 1;
+    return 0;
+  }
+  Vec2 pixelPos = {col, row};
+  *runEnd = col;
+  return abShapeCheck(l->abShape, pos, &pixelPos);
+}
+
+/** Returns 1 if one of spans covers col, pulling *runEnd in to the
+ *  first column at which coverage may change.
+ */
+static inline int
+spansRun(const Span spans[], int numSpans, int col, int *runEnd)
+{
+  int i;
+  for (i = 0; i < numSpans; i++) {
+    if (col < spans[i].colMin) { /* span begins later in the run */
+      if (*runEnd >= spans[i].colMin)
+	*runEnd = spans[i].colMin - 1;
+      return 0;
+    }
+    if (col <= spans[i].colMax) { /* layer covers col */
+      if (*runEnd > spans[i].colMax)
+	*runEnd = spans[i].colMax;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/** Determine the color of the run of pixels in row beginning at col.
+ *
+ *  The run ends at *runEnd (in/out), which is pulled in to the first
+ *  column at which a layer's coverage may change.  Every layer in the
+ *  list is queried; layers are placed at posLast rather than pos if
+ *  atLast is true.  Used when a row is crossed by too many layers to
+ *  cache their spans (see layerDrawRows).  spans is room for one
+ *  layer's query.
+ */
+static u_int
+layerRowRun(Layer *layers, int row, int col, int *runEnd, int atLast, Span spans[])
+{
+  Layer *l;
+  for (l = layers; l; l = l->next) {
+    const Vec2 *pos = atLast ? &l->posLast : &l->pos;
+    int numSpans = abShapeRowSpans(l->abShape, pos, row, spans);
+    if (numSpans < 0 ? layerProbe(l, pos, row, col, runEnd)
+	: spansRun(spans, numSpans, col, runEnd))
+      return l->color;
+  } // for checking all layers at col, row
+  return bgColor;
+}
+
+int layerScrollPos = 0;
+
+#ifdef LCD_STATS
+LayerStats layer_stats;
+
+#define LAYER_STAT_ADD(counter, n) (layer_stats.counter += (n))
+static u_char countChanges = 0;	/**< compare runs against posLast (layerRedrawDirty) */
+
+/** Number of pixels from col to runEnd whose color differs from when
+ *  the layers were at posLast
+ */
+static u_int
+layerRunChanges(Layer *layers, int row, int col, int runEnd, u_int color)
+{
+  u_int changed = 0;
+  Span spans[ABSHAPE_MAX_SPANS];
+  while (col <= runEnd) {
+    int oldEnd = runEnd;
+    if (layerRowRun(layers, row, col, &oldEnd, 1, spans) != color)
+      changed += oldEnd - col + 1;
+    col = oldEnd + 1;
+  }
+  return changed;
+}
+
+void layerStatsSnapshot(LayerStats *snapshot)
+{
+  *snapshot = layer_stats;
+}
+
+void layerStatsReset()
+{
+  static const LayerStats zeroStats;
+  layer_stats = zeroStats;
+}
+#else
+#define LAYER_STAT_ADD(counter, n) ((void)0)
+#endif
+
+/** Most layers that may be considered when drawing an area.
+ *  Areas crossed by more are drawn in bands of rows.
+ */
+#define LAYER_MAX_ACTIVE 5
+
+/** A layer that may cover some of the area being drawn, and its spans
+ *  in the row being drawn (set by layerDrawRows)
+ */
+typedef struct {
+  Layer *layer;
+  const AbShapeClass *shapeClass; /* 0 if it must be probed with check */
+  signed char numSpans;		/* 0: misses the row, -1: probe with check */
+  u_char firstSpan;		/* index of its first span in the row's cache */
+} ActiveLayer;
+
+/** Collect the layers whose bounding boxes intersect area, in order.
+ *  Returns their number, or -1 if there are more than LAYER_MAX_ACTIVE.
+ */
+static int
+layerCollect(Layer *layers, const Region *area, ActiveLayer active[])
+{
+  int numActive = 0;
+  Layer *l;
+  for (l = layers; l; l = l->next) {
+    Region bounds;
+    abShapeGetBounds(l->abShape, &l->pos, &bounds);
+    if (bounds.botRight.axes[0] < area->topLeft.axes[0]
+	|| bounds.topLeft.axes[0] > area->botRight.axes[0]
+	|| bounds.botRight.axes[1] < area->topLeft.axes[1]
+	|| bounds.topLeft.axes[1] > area->botRight.axes[1])
+      continue;
+    if (numActive == LAYER_MAX_ACTIVE)
+      return -1;
+    active[numActive].layer = l;
+    active[numActive].shapeClass = abShapeClassOf(l->abShape);
+    numActive++;
+  }
+  return numActive;
+}
+
+/** Spans cached per row by layerDrawRows (for all of the row's layers) */
+#define LAYER_ROW_SPANS 4
+
+/** Compute the spans of active's layer in row.
+ *  The shapes defined in shapeLib are dispatched on their kind to
+ *  inlined code (or a direct call for masks), others call their
+ *  class's rowSpans.
+ */
+static inline int
+layerSpans(const ActiveLayer *active, int row, Span spans[])
+{
+  const AbShape *shape = active->layer->abShape;
+  const Vec2 *pos = &active->layer->pos;
+  switch (active->shapeClass->kind) {
+  case ABSHAPE_RECT:
+    return rectSpans((const AbRect *)shape, pos, row, spans);
+  case ABSHAPE_RECT_OUTLINE:
+    return rectOutlineSpans((const AbRectOutline *)shape, pos, row, spans);
+  case ABSHAPE_RARROW:
+    return rArrowSpans((const AbRArrow *)shape, pos, row, spans);
+  case ABSHAPE_MASK:
+    return abMaskRowSpans((const AbMask *)shape, pos, row, spans);
+  default:
+    return (*active->shapeClass->rowSpans)(shape, pos, row, spans);
+  }
+}
+
+/** Determine the color of the run beginning at col from the spans
+ *  cached for the row's layers (see layerRowRun).
+ */
+static u_int
+layerCachedRun(const ActiveLayer active[], int numActive, const Span rowSpans[],
+	       int row, int col, int *runEnd)
+{
+  int i;
+  for (i = 0; i < numActive; i++) {
+    const ActiveLayer *a = &active[i];
+    if (a->numSpans < 0 ? layerProbe(a->layer, &a->layer->pos, row, col, runEnd)
+	: spansRun(&rowSpans[a->firstSpan], a->numSpans, col, runEnd))
+      return a->layer->color;
+  }
+  return bgColor;
+}
+
+/** Two scanlines of 4 bit palette indices (two pixels per byte) for
+ *  rows of up to scanlineWidth pixels, supplied by layerUseScanlines.
+ *  One is sent from lcdLib's queue while the next is resolved.
+ */
+static u_char *scanlines = 0;
+static u_char scanlineWidth = 0;
+static u_char scanlineNext = 0;	/**< the one not queued last */
+static u_int *palette;
+static u_char paletteSize = 0;
 
 void
-layerDraw(Layer *layers)
+layerUseScanlines(u_char *buffer, u_char width, u_int *colors, u_char numColors)
+{
+  lcd_queueWait(0);		/* the old buffers may be in use */
+  scanlines = buffer;
+  scanlineWidth = width;
+  palette = colors;
+  paletteSize = numColors < LCD_PALETTE_SIZE ? numColors : LCD_PALETTE_SIZE;
+}
+
+/** Load palette with bgColor and the colors of the active layers.
+ *  Returns the number of entries, or 0 if they do not fit.
+ */
+static int
+layerPalette(const ActiveLayer active[], int numActive)
+{
+  int numColors = 1, i, j;
+  if (!paletteSize)
+    return 0;
+  lcd_queueWait(0);		/* the palette may be in use */
+  palette[0] = bgColor;
+  for (i = 0; i < numActive; i++) {
+    u_int color = active[i].layer->color;
+    for (j = 0; j < numColors && palette[j] != color; j++)
+      ;
+    if (j < numColors)
+      continue;
+    if (numColors == paletteSize)
+      return 0;
+    palette[numColors++] = color;
+  }
+  return numColors;
+}
+
+/** Set the indices of pixels first to last of a scanline */
+static void
+scanlineFill(u_char *indices, int first, int last, u_char index)
 {
-  int row, col;
-  for (row = 0; row < screenHeight; row++) {
-    lcd_setArea(0, row, screenWidth-1, row);
-    for (col = 0; col < screenWidth; col++) {
-      Vec2 pixelPos = {col, row};
-      u_int color = bgColor;
-      Layer *probeLayer;
-      for (probeLayer = layers; probeLayer; probeLayer = probeLayer->next) {
-	if (abShapeCheck(probeLayer->abShape, &probeLayer->pos, &pixelPos)) {
-	  color = probeLayer->color;
-	  break; 
-	} /* if check */
-      } // for checking all layers at col, row
-      lcd_writeColor(color); 
-    } // for col
+  u_char *p = indices + (first >> 1);
+  u_char pair = index | index << 4;
+  if (first & 1) {		/* low nibble of a byte */
+    *p = (*p & 0xf0) | index;
+    p++;
+    first++;
+  }
+  for (; first < last; first += 2)
+    *p++ = pair;
+  if (first == last)		/* high nibble of a byte */
+    *p = (*p & 0x0f) | index << 4;
+}
+
+/** Draw area using the layers collected by layerCollect.  Each row
+ *  computes the spans of the active layers once (while they fit in
+ *  its cache; the rest are probed), then resolves its runs from them.
+ *  If numActive < 0 (only for a single row crossed by too many layers)
+ *  every layer is queried for every run.
+ *
+ *  Playfield row r is kept in memory row
+ *  lcd_scrollTop + (r - lcd_scrollTop) mod lcd_scrollRows,
+ *  so the visible rows wrap around within frame memory at most once.
+ *
+ *  If the rows fit in the scanlines and the colors in the palette
+ *  given to layerUseScanlines, each row is resolved into a scanline of
+ *  indices and queued with lcd_writeIndexed, which sends it while the
+ *  next row is resolved.  Otherwise runs are written as they are found.
+ */
+static void
+layerDrawRows(Layer *layers, ActiveLayer active[], int numActive, const Region *area)
+{
+  int visibleMin = lcd_scrollTop + layerScrollPos;
+  int colMin = area->topLeft.axes[0], rowMin = area->topLeft.axes[1];
+  int colMax = area->botRight.axes[0], rowMax = area->botRight.axes[1];
+  int row, col, memRow, memRowMax = -1, numColors;
+  Span rowSpans[LAYER_ROW_SPANS + ABSHAPE_MAX_SPANS]; /* room for the last layer's query,
+							 or layerRowRun's */
+  u_char window = 0;
+  if (colMin < 0) colMin = 0;
+  if (rowMin < visibleMin) rowMin = visibleMin;
+  if (colMax > screenWidth-1) colMax = screenWidth-1;
+  if (rowMax > visibleMin + lcd_scrollRows - 1) rowMax = visibleMin + lcd_scrollRows - 1;
+  if (colMin > colMax || rowMin > rowMax)
+    return;
+
+  memRow = (rowMin - lcd_scrollTop) % lcd_scrollRows;
+  if (memRow < 0)
+    memRow += lcd_scrollRows;
+  memRow += lcd_scrollTop;
+  numColors = (numActive >= 0 && colMax - colMin < scanlineWidth)
+    ? layerPalette(active, numActive) : 0;
+  for (row = rowMin; row <= rowMax; row++, memRow++) {
+    int i, numSpans = 0;
+    u_char *indices = scanlines + (scanlineNext ? (scanlineWidth + 1) / 2 : 0);
+    if (memRow > memRowMax) {	/* first row, or wrapped around */
+      if (memRow == lcd_scrollTop + lcd_scrollRows)
+	memRow = lcd_scrollTop;
+      memRowMax = memRow + (rowMax - row);
+      if (memRowMax > lcd_scrollTop + lcd_scrollRows - 1)
+	memRowMax = lcd_scrollTop + lcd_scrollRows - 1;
+      if (numColors)
+	lcd_queueArea(colMin, memRow, colMax, memRowMax);
+      else
+	lcd_setArea(colMin, memRow, colMax, memRowMax);
+      window = lcd_areaId();
+    }
+    for (i = 0; i < numActive; i++) {
+      ActiveLayer *a = &active[i];  /* span queries are 0 outside the bounds */
+      a->firstSpan = numSpans;
+      a->numSpans = -1;
+      if (a->shapeClass && numSpans < LAYER_ROW_SPANS) {
+	a->numSpans = layerSpans(a, row, &rowSpans[numSpans]);
+	if (a->numSpans > 0)
+	  numSpans += a->numSpans;
+      }
+    }
+    window = lcd_continueArea(window, colMin, memRow, colMax, memRowMax); /* in case a command intervened */
+    if (numColors)
+      lcd_queueWait(1);		/* only the other scanline may still be queued */
+    for (col = colMin; col <= colMax; ) {
+      int runEnd = colMax;
+      u_int color = numActive < 0 ? layerRowRun(layers, row, col, &runEnd, 0, rowSpans)
+	: layerCachedRun(active, numActive, rowSpans, row, col, &runEnd);
+#ifdef LCD_STATS
+      if (countChanges)
+	layer_stats.pixelsChanged += layerRunChanges(layers, row, col, runEnd, color);
+#endif
+      if (numColors) {
+	u_char index;
+	for (index = 0; palette[index] != color; index++)
+	  ;
+	scanlineFill(indices, col - colMin, runEnd - colMin, index);
+      } else
+	lcd_writeColorRun(color, runEnd - col + 1);
+      col = runEnd + 1;
+    } // for each run in row
+    if (numColors) {
+      lcd_writeIndexed(indices, colMax - colMin + 1, palette);
+      scanlineNext = !scanlineNext;
+    }
   } // for row
+}
+
+/** Draw the disjoint areas.  The layers intersecting their bounding
+ *  box are collected once.  If there are too many for the table, each
+ *  area is instead drawn in bands of rows, each small enough that the
+ *  layers intersecting it fit.
+ */
+static void
+layerDrawAreas(Layer *layers, const Region areas[], int numAreas)
+{
+  ActiveLayer active[LAYER_MAX_ACTIVE];
+  Region band = areas[0];
+  int numActive, i;
+  for (i = 1; i < numAreas; i++)
+    regionUnion(&band, &band, &areas[i]);
+  numActive = layerCollect(layers, &band, active);
+  for (; numAreas; numAreas--, areas++) {
+    int rowMax = areas->botRight.axes[1];
+    int bandRows = rowMax - areas->topLeft.axes[1] + 1, bandActive = numActive;
+    band = *areas;
+    while (band.topLeft.axes[1] <= rowMax) {
+      band.botRight.axes[1] = band.topLeft.axes[1] + bandRows - 1;
+      if (band.botRight.axes[1] > rowMax)
+	band.botRight.axes[1] = rowMax;
+      if (numActive < 0) {	/* too many layers for one table */
+	bandActive = layerCollect(layers, &band, active);
+	if (bandActive < 0 && bandRows > 1) { /* still too many: narrower band */
+	  bandRows = (bandRows + 1) / 2;
+	  continue;
+	}
+      }
+      layerDrawRows(layers, active, bandActive, &band);
+      band.topLeft.axes[1] = band.botRight.axes[1] + 1;
+    }
+  }
+}
+
+void
+layerDrawRegion(Layer *layers, const Region *area)
+{
+  layerDrawAreas(layers, area, 1);
+}
+
+void
+layerDraw(Layer *layers)
+{
+  Region screen = {{0, 0}, {screenWidth-1, screenHeight-1}};
+  layerDrawRegion(layers, &screen);
 } 
 
+void
+layerRedrawDirty(Layer *layers)
+{
+  Region dirty[LAYER_MAX_DIRTY];
+  int numDirty = layerDirtyRects(layers, dirty);
+  Layer *l;
+  if (numDirty) {
+#ifdef LCD_STATS
+    int i;
+    for (i = 0; i < numDirty; i++) {
+      LAYER_STAT_ADD(rects, 1);
+      LAYER_STAT_ADD(pixelsPainted, regionArea(&dirty[i]));
+    }
+    countChanges = 1;
+#endif
+    layerDrawAreas(layers, dirty, numDirty); /* bounds are found once per frame */
+#ifdef LCD_STATS
+    countChanges = 0;
+#endif
+  }
+  for (l = layers; l; l = l->next) /* all layers are now drawn at pos */
+    l->posLast = l->pos;
+}
+
+#ifdef LCD_CAN_SCROLL
+void
+layerScroll(Layer *layers, int rows)
+{
+  Region exposed = {{0, 0}, {screenWidth-1, 0}};
+  int offset;
+  if (!rows)
+    return;
+  if (rows > 0) {		/* rows appear below the scroll area */
+    exposed.topLeft.axes[1] = lcd_scrollTop + layerScrollPos + lcd_scrollRows;
+    exposed.botRight.axes[1] = exposed.topLeft.axes[1] + rows - 1;
+  } else {			/* rows appear above it */
+    exposed.botRight.axes[1] = lcd_scrollTop + layerScrollPos - 1;
+    exposed.topLeft.axes[1] = exposed.botRight.axes[1] + rows + 1;
+  }
+  layerScrollPos += rows;
+  offset = layerScrollPos % lcd_scrollRows;
+  if (offset < 0)
+    offset += lcd_scrollRows;
+  lcd_scrollTo(offset);
+  layerDrawRegion(layers, &exposed); /* clipped to the visible rows */
+}
+#endif
+
 
 
 void
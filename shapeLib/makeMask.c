@@ -0,0 +1,150 @@
+///////////////////////////////////////////
+// makeMask: convert a PBM/PGM/PPM image into an AbMask
+//
+// usage: makeMask image name
+//   writes name.c (the bitmap and "const AbMask name") and name.h.
+//   PBM pixels that are 1 (black) are set; PGM and PPM pixels are set
+//   if they are darker than half intensity.
+///////////////////////////////////////////
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "ctype.h"
+#include "assert.h"
+
+static int truncated = 0;	/* set if the image ends early */
+
+// skip white space and comments, then read an unsigned header field
+static int readNumber(FILE *fp)
+{
+  int c, n = 0;
+  while ((c = getc(fp)) != EOF && (isspace(c) || c == '#'))
+    if (c == '#')
+      while ((c = getc(fp)) != EOF && c != '\n')
+	;
+  if (!isdigit(c)) {
+    fprintf(stderr, "makeMask: malformed image header\n");
+    exit(1);
+  }
+  for (; isdigit(c); c = getc(fp))
+    n = n * 10 + (c - '0');
+  return n;
+}
+
+// read one sample (raw formats use 1 or 2 bytes each)
+static int readSample(FILE *fp, int raw, int maxVal)
+{
+  int c;
+  if (!raw)
+    return readNumber(fp);
+  c = getc(fp);
+  if (maxVal > 255)
+    c = (c << 8) | getc(fp);
+  if (feof(fp))
+    truncated = 1;
+  return c;
+}
+
+int main(int argc, char **argv)
+{
+  int format, width, height, maxVal = 1, row, col;
+  int stride;
+  unsigned char *bits;
+  char filename[100];
+  FILE *in, *fp;
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: makeMask image.pbm|pgm|ppm name\n");
+    return 1;
+  }
+  in = fopen(argv[1], "rb");
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+  if (getc(in) != 'P' || (format = getc(in) - '0') < 1 || format > 6) {
+    fprintf(stderr, "makeMask: %s is not a PBM, PGM or PPM image\n", argv[1]);
+    return 1;
+  }
+  width = readNumber(in);
+  height = readNumber(in);
+  if (format != 1 && format != 4)
+    maxVal = readNumber(in);	/* followed by a single white space */
+  if (width < 1 || width > 255 || height < 1 || height > 255) {
+    fprintf(stderr, "makeMask: masks are at most 255x255 pixels\n");
+    return 1;
+  }
+
+  stride = (width + 7) / 8;
+  bits = calloc(stride * height, 1);
+  assert(bits);
+  for (row = 0; row < height; row++) {
+    unsigned char *rowBits = bits + row * stride;
+    if (format == 4) {		/* raw PBM is already packed msb first */
+      if (fread(rowBits, 1, stride, in) != (size_t)stride)
+	truncated = 1;
+      if (width & 7)		/* clear the padding */
+	rowBits[stride-1] &= 0xff << (8 - (width & 7));
+      continue;
+    }
+    for (col = 0; col < width; col++) {
+      int set;
+      if (format == 1) {	/* plain PBM: digits, possibly unseparated */
+	int c;
+	while ((c = getc(in)) != EOF && c != '0' && c != '1')
+	  ;
+	if (c == EOF)
+	  truncated = 1;
+	set = c == '1';
+      } else if (format == 2 || format == 5) {
+	set = 2 * readSample(in, format == 5, maxVal) < maxVal;
+      } else {
+	int raw = format == 6;
+	int sum = readSample(in, raw, maxVal);
+	sum += readSample(in, raw, maxVal);
+	sum += readSample(in, raw, maxVal);
+	set = 2 * sum < 3 * maxVal;
+      }
+      if (set)
+	rowBits[col / 8] |= 0x80 >> (col % 8);
+    }
+  }
+  if (truncated || ferror(in)) {
+    fprintf(stderr, "makeMask: %s is truncated\n", argv[1]);
+    return 1;
+  }
+  fclose(in);
+
+  sprintf(filename, "%.90s.c", argv[2]);
+  fp = fopen(filename, "w");
+  assert(fp);
+  fprintf(fp, "// Automatically generated by makeMask from %s\n", argv[1]);
+  fprintf(fp, "#include \"%s.h\"\n\n", argv[2]);
+  fprintf(fp, "static const unsigned char %sBits[%d] = {\n", argv[2], stride * height);
+  for (row = 0; row < height; row++) {
+    fprintf(fp, "   ");
+    for (col = 0; col < stride; col++)
+      fprintf(fp, " 0x%02x,", bits[row * stride + col]);
+    fprintf(fp, " // ");
+    for (col = 0; col < width; col++)
+      fputc((bits[row * stride + col / 8] & (0x80 >> (col % 8))) ? '#' : '.', fp);
+    fprintf(fp, "\n");
+  }
+  fprintf(fp, "};\n\n");
+  fprintf(fp, "const AbMask %s = {\n", argv[2]);
+  fprintf(fp, "  abMaskGetBounds, abMaskCheck, %d, %d, %sBits\n", width, height, argv[2]);
+  fprintf(fp, "};\n");
+  fclose(fp);
+
+  sprintf(filename, "%.90s.h", argv[2]);
+  fp = fopen(filename, "w");
+  assert(fp);
+  fprintf(fp, "// Automatically generated by makeMask from %s\n", argv[1]);
+  fprintf(fp, "#ifndef %s_included\n#define %s_included\n\n", argv[2], argv[2]);
+  fprintf(fp, "#include \"shape.h\"\n\n");
+  fprintf(fp, "extern const AbMask %s;\n", argv[2]);
+  fprintf(fp, "\n#endif // included\n");
+  fclose(fp);
+  free(bits);
+  return 0;
+}
@@ -0,0 +1,60 @@
+#include "shape.h"
+
+// compute bounding box in screen coordinates for mask at centerPos
+void
+abMaskGetBounds(const AbMask *mask, const Vec2 *centerPos, Region *bounds)
+{
+  bounds->topLeft.axes[0] = centerPos->axes[0] - mask->width / 2;
+  bounds->topLeft.axes[1] = centerPos->axes[1] - mask->height / 2;
+  bounds->botRight.axes[0] = bounds->topLeft.axes[0] + mask->width - 1;
+  bounds->botRight.axes[1] = bounds->topLeft.axes[1] + mask->height - 1;
+}
+
+// true if pixel's bit is set: a single table lookup
+int
+abMaskCheck(const AbMask *mask, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  int col = pixel->axes[0] - (centerPos->axes[0] - mask->width / 2);
+  int row = pixel->axes[1] - (centerPos->axes[1] - mask->height / 2);
+  if (col < 0 || col >= mask->width || row < 0 || row >= mask->height)
+    return 0;
+  return (mask->bits[row * ((mask->width + 7) >> 3) + (col >> 3)] << (col & 7)) & 0x80;
+}
+
+/* runs of set bits in the row become spans.
+ * Bytes that are all clear (outside a run) or all set (inside one)
+ * are skipped whole.
+ */
+int
+abMaskRowSpans(const AbMask *mask, const Vec2 *centerPos, int row, Span spans[])
+{
+  int colLeft = centerPos->axes[0] - mask->width / 2;
+  int width = mask->width, col = 0, numSpans = 0, inRun = 0;
+  const u_char *bits;
+  row -= centerPos->axes[1] - mask->height / 2;
+  if (row < 0 || row >= mask->height)
+    return 0;
+  bits = mask->bits + row * ((width + 7) >> 3);
+  while (col < width) {
+    u_char b = *bits++;
+    if (b == (inRun ? 0xff : 0x00)) { /* no change within this byte */
+      col += 8;
+      continue;
+    }
+    u_char bit;
+    for (bit = 0x80; bit && col < width; bit >>= 1, col++) {
+      if (((b & bit) != 0) == inRun)
+	continue;
+      if (inRun)		/* run ended before col */
+	spans[numSpans++].colMax = colLeft + col - 1;
+      else if (numSpans == ABSHAPE_MAX_SPANS)
+	return -1;		/* too many runs: probe with check */
+      else
+	spans[numSpans].colMin = colLeft + col;
+      inRun = !inRun;
+    }
+  }
+  if (inRun)
+    spans[numSpans++].colMax = colLeft + width - 1;
+  return numSpans;
+}
@@ -0,0 +1,17 @@
+// Automatically generated by makeMask from invader.pbm
+#include "invader.h"
+
+static const unsigned char invaderBits[16] = {
+    0x20, 0x80, // ..#.....#..
+    0x11, 0x00, // ...#...#...
+    0x3f, 0x80, // ..#######..
+    0x6e, 0xc0, // .##.###.##.
+    0xff, 0xe0, // ###########
+    0xbf, 0xa0, // #.#######.#
+    0xa0, 0xa0, // #.#.....#.#
+    0x1b, 0x00, // ...##.##...
+};
+
+const AbMask invader = {
+  abMaskGetBounds, abMaskCheck, 11, 8, invaderBits
+};
@@ -0,0 +1,9 @@
+// Automatically generated by makeMask from invader.pbm
+#ifndef invader_included
+#define invader_included
+
+#include "shape.h"
+
+extern const AbMask invader;
+
+#endif // included
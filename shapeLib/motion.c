@@ -0,0 +1,69 @@
+#include "shape.h"
+
+#define Q8_8_MAX 0x7eff		/* just under 127 pixels */
+
+/* v + a, saturated to +-Q8_8_MAX */
+static int
+addVelocity(int v, int a)
+{
+  if (a > 0 && v > Q8_8_MAX - a)
+    return Q8_8_MAX;
+  if (a < 0 && v < -Q8_8_MAX - a)
+    return -Q8_8_MAX;
+  return v + a;
+}
+
+/* v less 1/2^friction of itself, rounded away from zero so that slow
+ * motions come to a stop.
+ */
+static int
+applyFriction(int v, u_char friction)
+{
+  if (v > 0)
+    return v - ((v + (1 << friction) - 1) >> friction);
+  return v - (v >> friction);	/* >> rounds negative v down */
+}
+
+int
+motionAdvance(Motion *m, const Region *fence)
+{
+  int moved = 0;
+  for (; m; m = m->next) {
+    Vec2 *pos = &m->layer->posNext;
+    Vec2 newPos;
+    int step[2];
+    u_char axis;
+    for (axis = 0; axis < 2; axis++) {
+      int v = addVelocity(m->velocity.axes[axis], m->accel.axes[axis]);
+      if (m->friction)
+	v = applyFriction(v, m->friction);
+      m->velocity.axes[axis] = v;
+      step[axis] = m->fraction[axis] + v; /* Q8.8: fraction is 0..255 */
+      newPos.axes[axis] = pos->axes[axis] + (step[axis] >> 8);
+    }
+    if (newPos.axes[0] == pos->axes[0] && newPos.axes[1] == pos->axes[1]) {
+      m->fraction[0] = step[0];	/* same pixel: no bounds to check */
+      m->fraction[1] = step[1];
+      continue;
+    }
+    if (fence) {
+      Region bounds;
+      abShapeGetBounds(m->layer->abShape, &newPos, &bounds);
+      for (axis = 0; axis < 2; axis++) {
+	if (bounds.topLeft.axes[axis] < fence->topLeft.axes[axis] ||
+	    bounds.botRight.axes[axis] > fence->botRight.axes[axis]) {
+	  int v = m->velocity.axes[axis] = -m->velocity.axes[axis];
+	  step[axis] = m->fraction[axis] + v; /* reflected step */
+	  newPos.axes[axis] = pos->axes[axis] + (step[axis] >> 8);
+	}
+      }
+    }
+    m->fraction[0] = step[0];
+    m->fraction[1] = step[1];
+    if (newPos.axes[0] != pos->axes[0] || newPos.axes[1] != pos->axes[1]) {
+      *pos = newPos;
+      moved = 1;
+    }
+  }
+  return moved;
+}
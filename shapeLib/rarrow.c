@@ -1,4 +1,5 @@
 #include "shape.h"
+#include "shapeSpans.h"
 
 
 /** Check function required by AbShape
@@ -24,6 +25,17 @@ abRArrowCheck(const AbRArrow *arrow, const Vec2 *centerPos, const Vec2 *pixel)
   return within;
 }
   
+/** Span function required by AbShapeClass
+ *  abRArrowRowSpans computes the single span covered by a right arrow in row.
+ *  Rows within the stem extend from the arrow's tail to the tip's edge;
+ *  other rows are covered only by the tip.
+ */
+int
+abRArrowRowSpans(const AbRArrow *arrow, const Vec2 *centerPos, int row, Span spans[])
+{
+  return rArrowSpans(arrow, centerPos, row, spans);
+}
+
 /** Check function required by AbShape
  *  abRArrowGetBounds computes a right arrow's bounding box
  */
@@ -1,18 +1,24 @@
 #include "shape.h"
+#include "shapeSpans.h"
 
 // true if pixel is in rect centerPosed at rectPos
 int 
 abRectCheck(const AbRect *rect, const Vec2 *centerPos, const Vec2 *pixel)
 {
-  Region bounds;
-  abRectGetBounds(rect, centerPos, &bounds);
-  int within = 1, axis;
+  int axis;
   for (axis = 0; axis < 2; axis ++) {
-    int p = pixel->axes[axis];
-    if (p > bounds.botRight.axes[axis] || p < bounds.topLeft.axes[axis])
-      within = 0;
+    int offset = pixel->axes[axis] - centerPos->axes[axis];
+    if (offset > rect->halfSize.axes[axis] || offset < -rect->halfSize.axes[axis])
+      return 0;
   }
-  return within;
+  return 1;
+}
+
+// the rect covers one span in rows within its bounds
+int
+abRectRowSpans(const AbRect *rect, const Vec2 *centerPos, int row, Span spans[])
+{
+  return rectSpans(rect, centerPos, row, spans);
 }
 
 // compute bounding box in screen coordinates for rect at centerPos
@@ -28,20 +34,26 @@ void abRectGetBounds(const AbRect *rect, const Vec2 *centerPos, Region *bounds)
 int 
 abRectOutlineCheck(const AbRectOutline *rect, const Vec2 *centerPos, const Vec2 *pixel)
 {
-  Region bounds;
-  abRectOutlineGetBounds(rect, centerPos, &bounds);
-  int col = pixel->axes[0], row = pixel->axes[1];
+  int col = pixel->axes[0] - centerPos->axes[0], row = pixel->axes[1] - centerPos->axes[1];
+  int halfWidth = rect->halfSize.axes[0], halfHeight = rect->halfSize.axes[1];
   return (
-	  ((col == bounds.topLeft.axes[0] || col == bounds.botRight.axes[0])
+	  ((col == -halfWidth || col == halfWidth)
 	   && 
-	   (row >= bounds.topLeft.axes[1] && row <= bounds.botRight.axes[1]))
+	   (row >= -halfHeight && row <= halfHeight))
 	  ||
-	  ((row == bounds.topLeft.axes[1] || row == bounds.botRight.axes[1])
+	  ((row == -halfHeight || row == halfHeight)
 	   &&
-	   (col >= bounds.topLeft.axes[0] && col <= bounds.botRight.axes[0]))
+	   (col >= -halfWidth && col <= halfWidth))
 	  );
 }
  
+// top & bottom rows are a single span, other rows are the two sides
+int
+abRectOutlineRowSpans(const AbRectOutline *rect, const Vec2 *centerPos, int row, Span spans[])
+{
+  return rectOutlineSpans(rect, centerPos, row, spans);
+}
+ 
 // compute bounding box in screen coordinates for rect at centerPos
 void abRectOutlineGetBounds(const AbRectOutline *rect, const Vec2 *centerPos, Region *bounds)
 {
@@ -8,10 +8,13 @@ regionUnion(Region *rUnion, const Region *r1, const Region *r2)
   vec2Max(&rUnion->botRight, &r1->botRight, &r2->botRight);
 }
 
-// Trims extent of region to screen bounds
+// Trims extent of region to screen bounds (the visible rows of a scrolled playfield)
 void regionClipScreen(Region *r)
 {
-  vec2Max(&r->topLeft, &r->topLeft, &vec2Zero);
-  vec2Min(&r->botRight, &r->botRight, &screenSize);
+  int rowMin = lcd_scrollTop + layerScrollPos, rowMax = rowMin + lcd_scrollRows;
+  if (r->topLeft.axes[0] < 0) r->topLeft.axes[0] = 0;
+  if (r->topLeft.axes[1] < rowMin) r->topLeft.axes[1] = rowMin;
+  if (r->botRight.axes[0] > screenWidth) r->botRight.axes[0] = screenWidth;
+  if (r->botRight.axes[1] > rowMax) r->botRight.axes[1] = rowMax;
 }
 
@@ -0,0 +1,160 @@
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "shape.h"
+
+enum { RENDER_FILL, RENDER_STRING, RENDER_CHAR, RENDER_LAYERS };
+
+/* Commands from tail to head are waiting.  Interrupt handlers only
+ * write head and renderDrain only writes tail.
+ */
+static RenderCmd *queue;
+static u_char queueMask;	/* size - 1 */
+static volatile u_char head, tail;
+u_char renderDropped;
+
+#define BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+/* true if cmd draws over exactly what queued would */
+static int
+samePlace(const RenderCmd *queued, const RenderCmd *cmd)
+{
+  if (queued->op != cmd->op)
+    return 0;
+  switch (cmd->op) {
+  case RENDER_FILL:
+    return queued->col == cmd->col && queued->row == cmd->row &&
+      queued->u.size.width == cmd->u.size.width &&
+      queued->u.size.height == cmd->u.size.height;
+  case RENDER_LAYERS:
+    return queued->u.layers == cmd->u.layers;
+  default:			/* text */
+    return queued->col == cmd->col && queued->row == cmd->row &&
+      queued->font == cmd->font;
+  }
+}
+
+void
+renderInit(RenderCmd *cmds, u_char size)
+{
+  queue = cmds;
+  queueMask = size - 1;
+  head = tail = 0;
+}
+
+static void
+post(const RenderCmd *cmd)
+{
+  u_char h = head, waiting = h - tail;
+  /* renderDrain only reads the command at tail, so with at least two
+   * waiting the last one is safe to replace
+   */
+  if (waiting >= 2 && samePlace(&queue[(u_char)(h - 1) & queueMask], cmd)) {
+    queue[(u_char)(h - 1) & queueMask] = *cmd;
+    return;
+  }
+  if (!queue || waiting > queueMask) {
+    renderDropped++;
+    return;
+  }
+  queue[h & queueMask] = *cmd;
+  BARRIER();
+  head = h + 1;
+}
+
+void
+renderFill(u_char col, u_char row, u_char width, u_char height, u_int color)
+{
+  RenderCmd cmd;
+  cmd.op = RENDER_FILL;
+  cmd.col = col, cmd.row = row;
+  cmd.u.size.width = width, cmd.u.size.height = height;
+  cmd.fgColor = color;
+  post(&cmd);
+}
+
+void
+renderString(u_char col, u_char row, const char *string, u_char font,
+	     u_int fgColor, u_int bgColor)
+{
+  RenderCmd cmd;
+  cmd.op = RENDER_STRING, cmd.font = font;
+  cmd.col = col, cmd.row = row;
+  cmd.u.string = string;
+  cmd.fgColor = fgColor, cmd.bgColor = bgColor;
+  post(&cmd);
+}
+
+void
+renderChar(u_char col, u_char row, char c, u_char font,
+	   u_int fgColor, u_int bgColor)
+{
+  RenderCmd cmd;
+  cmd.op = RENDER_CHAR, cmd.font = font;
+  cmd.col = col, cmd.row = row;
+  cmd.u.c = c;
+  cmd.fgColor = fgColor, cmd.bgColor = bgColor;
+  post(&cmd);
+}
+
+void
+renderLayers(Layer *layers)
+{
+  RenderCmd cmd;
+  cmd.op = RENDER_LAYERS;
+  cmd.u.layers = layers;
+  post(&cmd);
+}
+
+int
+renderPending()
+{
+  return head != tail;
+}
+
+static void
+drawText(const RenderCmd *cmd)
+{
+  char str[2];
+  char *string = (char *)cmd->u.string;
+  if (cmd->op == RENDER_CHAR) {
+    str[0] = cmd->u.c, str[1] = 0;
+    string = str;
+  }
+  switch (cmd->font) {
+  case RENDER_FONT_5X7:
+    drawString5x7(cmd->col, cmd->row, string, cmd->fgColor, cmd->bgColor);
+    break;
+  case RENDER_FONT_8X12:
+    drawString8x12(cmd->col, cmd->row, string, cmd->fgColor, cmd->bgColor);
+    break;
+  default:
+    drawString11x16(cmd->col, cmd->row, string, cmd->fgColor, cmd->bgColor);
+  }
+}
+
+int
+renderDrain()
+{
+  int drawn = 0;
+  u_char t;
+  while ((t = tail) != head) {
+    RenderCmd cmd;
+    BARRIER();
+    cmd = queue[t & queueMask];
+    BARRIER();
+    tail = t + 1;		/* the slot may now be reused */
+    switch (cmd.op) {
+    case RENDER_FILL:
+      fillRectangle(cmd.col, cmd.row, cmd.u.size.width, cmd.u.size.height,
+		    cmd.fgColor);
+      break;
+    case RENDER_LAYERS:
+      layerRedrawDirty(cmd.u.layers);
+      break;
+    default:
+      drawText(&cmd);
+    }
+    drawn++;
+  }
+  return drawn;
+}
@@ -22,3 +22,51 @@ abShapeCheck(const AbShape *s, const Vec2 *centerPos, const Vec2 *pixelLoc)
   return (*s->check)(s, centerPos, pixelLoc);
 }
 
+
+/* span queries for the shapes defined in this library (in flash) */
+static const AbShapeClass abMaskClass = {
+  (void *)abMaskCheck, (void *)abMaskRowSpans, 0, ABSHAPE_MASK
+};
+static const AbShapeClass abRArrowClass = {
+  (void *)abRArrowCheck, (void *)abRArrowRowSpans, &abMaskClass, ABSHAPE_RARROW
+};
+static const AbShapeClass abRectOutlineClass = {
+  (void *)abRectOutlineCheck, (void *)abRectOutlineRowSpans, &abRArrowClass,
+  ABSHAPE_RECT_OUTLINE
+};
+static const AbShapeClass abRectClass = {
+  (void *)abRectCheck, (void *)abRectRowSpans, &abRectOutlineClass,
+  ABSHAPE_RECT
+};
+
+static const AbShapeClass *abShapeClasses = &abRectClass;
+
+void
+abShapeRegisterClass(AbShapeClass *shapeClass)
+{
+  const AbShapeClass *c;
+  for (c = abShapeClasses; c; c = c->next)
+    if (c == shapeClass)	/* already registered */
+      return;
+  shapeClass->next = abShapeClasses;
+  abShapeClasses = shapeClass;
+}
+
+const AbShapeClass *
+abShapeClassOf(const AbShape *s)
+{
+  const AbShapeClass *c;
+  for (c = abShapeClasses; c; c = c->next)
+    if (c->check == s->check)
+      return c;
+  return 0;
+}
+
+int
+abShapeRowSpans(const AbShape *s, const Vec2 *centerPos, int row, Span spans[])
+{
+  const AbShapeClass *c = abShapeClassOf(s);
+  if (!c)
+    return -1;			/* unknown class: caller must use check */
+  return (*c->rowSpans)(s, centerPos, row, spans);
+}
@@ -59,6 +59,7 @@ typedef struct {
 void regionUnion(Region *rUnion, const Region *r1, const Region *r2);
 
 /** Clip region within screen bounds
+ *  (the visible rows of the playfield when scrolled by layerScroll)
  */
 void regionClipScreen(Region *region);
 
@@ -102,6 +103,71 @@ void abShapeGetBounds(const AbShape *s, const Vec2 *centerPos, Region *bounds);
  */
 int abShapeCheck(const AbShape *shape, const Vec2 *centerPos, const Vec2 *pixelLoc);
 
+/** A horizontal run of pixels within a single row.
+ *  Columns colMin through colMax (inclusive) are covered.
+ */
+typedef struct {
+  int colMin, colMax;
+} Span;
+
+/** Maximum number of spans a row query may report */
+#define ABSHAPE_MAX_SPANS 4
+
+/** Kinds of AbShape known to the compositor
+ *
+ *  The compositor computes the spans of the kinds defined in shapeLib
+ *  with inlined code rather than calls through the class.
+ */
+typedef enum {
+  ABSHAPE_CUSTOM = 0,		/**< spans only via rowSpans (or check) */
+  ABSHAPE_RECT,
+  ABSHAPE_RECT_OUTLINE,
+  ABSHAPE_RARROW,
+  ABSHAPE_MASK
+} AbShapeKind;
+
+/** Optional per-row span query for a class of AbShapes
+ *
+ *  AbShapes sharing a check function form a class.  A class may
+ *  register a rowSpans function that reports which column ranges are
+ *  covered by the shape in a given row, allowing renderers to stream
+ *  runs of a single color rather than calling check for every pixel.
+ *
+ *  rowSpans stores up to ABSHAPE_MAX_SPANS spans (ordered left to
+ *  right, non-overlapping) and returns their count.  It returns -1 if
+ *  the row cannot be described with spans, in which case renderers
+ *  fall back to check.
+ *
+ *  kind tags the class's shapes (an AbShapeKind); classes defined
+ *  outside shapeLib leave it 0 (ABSHAPE_CUSTOM).
+ */
+typedef struct AbShapeClass_s {
+  int (*check)(const AbShape *shape, const Vec2 *centerPos, const Vec2 *pixelLoc);
+  int (*rowSpans)(const AbShape *shape, const Vec2 *centerPos, int row, Span spans[]);
+  const struct AbShapeClass_s *next;
+  u_char kind;
+} AbShapeClass;
+
+/** Register a class's span query.
+ *  AbRect, AbRectOutline, AbRArrow and AbMask are registered by default.
+ */
+void abShapeRegisterClass(AbShapeClass *shapeClass);
+
+/** The registered class of shape, or 0 if its class has no span query.
+ *  Renderers look this up once per shape rather than once per row.
+ */
+const AbShapeClass *abShapeClassOf(const AbShape *shape);
+
+/** Compute the spans covered by shape at centerPos within row
+ *
+ *  \param shape (in) The abstract shape
+ *  \param centerPos (in) The Vec2 specifying the center position of the shape
+ *  \param row (in) The row being queried
+ *  \param spans (out) At most ABSHAPE_MAX_SPANS spans, ordered left to right
+ *  \return The number of spans, or -1 if shape's class has no span query
+ */
+int abShapeRowSpans(const AbShape *shape, const Vec2 *centerPos, int row, Span spans[]);
+
 /** An AbShape Right Arrow with filled tip
  *
  *  size: width of the arrow.  Tip is a triangle with width=1/2 size.
@@ -121,6 +187,10 @@ void abRArrowGetBounds(const AbRArrow *arrow, const Vec2 *centerPos, Region *bou
  */
 int abRArrowCheck(const AbRArrow *arrow, const Vec2 *centerPos, const Vec2 *pixel);
 
+/** As required by AbShapeClass
+ */
+int abRArrowRowSpans(const AbRArrow *arrow, const Vec2 *centerPos, int row, Span spans[]);
+
 /** AbShape rectangle
  *
  *  Vector halfSize must be to first quadrant (both axes non-negative).  
@@ -140,6 +210,10 @@ void abRectGetBounds(const AbRect *rect, const Vec2 *centerPos, Region *bounds);
  */
 int abRectCheck(const AbRect *rect, const Vec2 *centerPos, const Vec2 *pixel);
 
+/** As required by AbShapeClass
+ */
+int abRectRowSpans(const AbRect *rect, const Vec2 *centerPos, int row, Span spans[]);
+
 typedef AbRect AbRectOutline;	/* same as AbRect */
 
 /** As required by AbShape
@@ -150,6 +224,38 @@ void abRectOutlineGetBounds(const AbRect *rect, const Vec2 *centerPos, Region *b
  */
 int abRectOutlineCheck(const AbRect *rect, const Vec2 *centerPos, const Vec2 *pixel);
 
+/** As required by AbShapeClass
+ */
+int abRectOutlineRowSpans(const AbRect *rect, const Vec2 *centerPos, int row, Span spans[]);
+
+/** AbShape defined by a 1 bit per pixel bitmap (usually in flash)
+ *
+ *  The bitmap has height rows of (width+7)/8 bytes.  The most
+ *  significant bit of a byte is its leftmost pixel (as in PBM images),
+ *  and a set bit is covered by the shape.  centerPos is the pixel at
+ *  (width/2, height/2).  Bitmaps can be generated from PBM/PPM images
+ *  with makeMask (see README.md).
+ */
+typedef struct AbMask_s {
+  void (*getBounds)(const struct AbMask_s *mask, const Vec2 *centerPos, Region *bounds);
+  int (*check)(const struct AbMask_s *mask, const Vec2 *centerPos, const Vec2 *pixel);
+  u_char width, height;
+  const u_char *bits;
+} AbMask;
+
+/** As required by AbShape
+ */
+void abMaskGetBounds(const AbMask *mask, const Vec2 *centerPos, Region *bounds);
+
+/** As required by AbShape
+ */
+int abMaskCheck(const AbMask *mask, const Vec2 *centerPos, const Vec2 *pixel);
+
+/** As required by AbShapeClass
+ *  Returns -1 for rows with more than ABSHAPE_MAX_SPANS runs of set bits.
+ */
+int abMaskRowSpans(const AbMask *mask, const Vec2 *centerPos, int row, Span spans[]);
+
 /** Linked list of Layers.  
  * 
  *  Each layer contains
@@ -165,7 +271,7 @@ int abRectOutlineCheck(const AbRect *rect, const Vec2 *centerPos, const Vec2 *pi
  *   - next: a reference to the next layer behind this layer
  */
 typedef struct Layer_s {
-  AbShape *abShape;
+  const AbShape *abShape;
   Vec2 pos, posLast, posNext; /* initially just set pos */
   u_int color;
   struct Layer_s *next;
@@ -185,6 +291,165 @@ void layerInit(Layer *layers);
  */
 void layerDraw(Layer *layers);
 
+/** Render all layers within area (inclusive, clipped to the screen).
+ *  Rows are playfield rows, see layerScroll.
+ *  Each row is composited from the layers' spans and streamed as
+ *  runs of a single color.  Layers whose shapes lack a span query
+ *  are probed with check within their bounding boxes.
+ */
+void layerDrawRegion(Layer *layers, const Region *area);
+
+/** Buffers for palette-indexed drawing
+ *
+ *  Rows of up to width pixels whose colors (bgColor and the layers')
+ *  fit in palette are resolved into a scanline of 4 bit indices and
+ *  sent from lcdLib's queue while the next row is resolved.  buffer
+ *  holds two scanlines of (width + 1) / 2 bytes; palette holds up to
+ *  numColors (at most LCD_PALETTE_SIZE) colors.  Until this is called,
+ *  and for wider rows, runs are written as they are found, so a
+ *  program only spends RAM on the rows it wants streamed.
+ *
+ *  e.g. u_char scanlines[2 * 16]; u_int palette[4];
+ *       layerUseScanlines(scanlines, 32, palette, 4);
+ */
+void layerUseScanlines(u_char *buffer, u_char width, u_int *palette, u_char numColors);
+
+/** Redraw the parts of the screen changed by layers that moved
+ *
+ *  Layers whose pos differs from posLast (where they were last drawn)
+ *  contribute the strips where their coverage changed or, for shapes
+ *  that are not a single span in every row, their old and new
+ *  bounding boxes.  Overlapping boxes are
+ *  merged so that each pixel is painted at most once, and
+ *  boxes whose union would waste area are kept separate.  Afterwards
+ *  every layer's posLast is set to pos.
+ */
+void layerRedrawDirty(Layer *layers);
+
+/** Compositor statistics
+ *
+ *  Compiled in only when shapeLib (and the program using these) is
+ *  built with -DLCD_STATS.
+ */
+typedef struct {
+  unsigned long pixelsPainted;	/**< pixels sent by layerRedrawDirty */
+  unsigned long pixelsChanged;	/**< of those, pixels whose color changed */
+  u_int rects;			/**< dirty rectangles painted */
+} LayerStats;
+
+#ifdef LCD_STATS
+extern LayerStats layer_stats;
+
+/** Copy the current statistics into snapshot */
+void layerStatsSnapshot(LayerStats *snapshot);
+
+/** Zero the statistics */
+void layerStatsReset();
+#endif
+
+/** Hardware-scroll the playfield (see lcd_scrollDefine in lcdutils.h)
+ *
+ *  Layer positions are playfield coordinates: playfield row
+ *  r is shown on screen row r - layerScrollPos.  Scrolling by rows
+ *  (positive to move down the playfield) redraws only the rows that
+ *  become visible.  Layers are only drawn within the scroll area.
+ */
+#ifdef LCD_CAN_SCROLL
+void layerScroll(Layer *layers, int rows);
+#endif
+
+/** Rows the playfield has been scrolled (read only) */
+extern int layerScrollPos;
+
+/** Q8.8 fixed point: the low 8 bits are 1/256ths of a pixel.
+ *  Q8_8(1.5) converts a constant (384).
+ */
+#define Q8_8(pixels) ((int)((pixels) * 256))
+
+/** A layer moving with sub-pixel precision
+ *
+ *  velocity and accel are Q8.8 pixels per tick (and per tick per tick),
+ *  and velocity is kept below 127 pixels per tick.  Each tick velocity
+ *  loses 1/2^friction of itself (0: no friction).  The layer's posNext
+ *  holds the position's integer part and fraction its 1/256ths, so
+ *  only whole pixel moves reach the compositor.
+ */
+typedef struct Motion_s {
+  Layer *layer;
+  Vec2 velocity, accel;
+  u_char friction;
+  u_char fraction[2];		/**< initially 0 */
+  struct Motion_s *next;
+} Motion;
+
+/** Advance each motion in the list by one tick
+ *
+ *  Shapes that would leave fence (if not 0) bounce: that axis's
+ *  velocity is reversed and the step is reflected.  Uses only 16 bit
+ *  adds and shifts.
+ *
+ *  \return true if some layer's posNext changed
+ */
+int motionAdvance(Motion *motions, const Region *fence);
+
+/** Deferred drawing
+ *
+ *  Interrupt handlers should not draw: drawing from them blocks other
+ *  interrupts for the whole transfer and can interleave with the main
+ *  loop's drawing (e.g. in the middle of layerRedrawDirty's window).
+ *  Instead they queue commands with renderFill, renderString,
+ *  renderChar and renderLayers, and the main loop draws them in order
+ *  with renderDrain.
+ *
+ *  A command for the same place as the last one queued (same text
+ *  position and font, same rectangle, or same layers) replaces it
+ *  unless the main loop may already be drawing it.  Strings are not
+ *  copied, so they must remain unchanged until drawn (string constants
+ *  are fine).  Commands are queued either only by interrupt handlers
+ *  or only by the main loop (or with interrupts disabled); when the
+ *  queue is full they are counted in renderDropped and discarded.
+ *
+ *  The program supplies the queue, sized for the commands it queues
+ *  between renderDrain calls; until renderInit is called every command
+ *  is dropped.
+ */
+enum { RENDER_FONT_5X7, RENDER_FONT_8X12, RENDER_FONT_11X16 };
+
+/** A queued command (10 bytes) */
+typedef struct {
+  u_char op, font, col, row;
+  union {
+    struct { u_char width, height; } size; /* RENDER_FILL */
+    const char *string;
+    char c;
+    Layer *layers;
+  } u;
+  u_int fgColor, bgColor;	/* RENDER_FILL uses fgColor */
+} RenderCmd;
+
+/** Queue commands in queue, which holds size (a power of two) commands
+ *
+ *  e.g. static RenderCmd renderQueue[2]; renderInit(renderQueue, 2);
+ */
+void renderInit(RenderCmd *queue, u_char size);
+
+void renderFill(u_char col, u_char row, u_char width, u_char height, u_int color);
+void renderString(u_char col, u_char row, const char *string, u_char font,
+		  u_int fgColor, u_int bgColor);
+void renderChar(u_char col, u_char row, char c, u_char font,
+		u_int fgColor, u_int bgColor);
+
+/** Queue layerRedrawDirty(layers) */
+void renderLayers(Layer *layers);
+
+/** True if commands are waiting (e.g. to decide to wake the main loop) */
+int renderPending();
+
+/** Draw queued commands (main loop only).  Returns how many were drawn. */
+int renderDrain();
+
+extern u_char renderDropped;
+
 /** Background color.
   */
 extern u_int bgColor;		/*  background color */
@@ -2,6 +2,7 @@
 #include "lcdutils.h"
 #include "lcddraw.h"
 #include "shape.h"
+#include "masks/invader.h"
 
 // like abRectCheck, but excludes a triangle
 int 
@@ -23,13 +24,20 @@ AbRect rect10 = {abRectGetBounds, abSlicedRectCheck, 10,10};;
 Region fence = {{10,30}, {SHORT_EDGE_PIXELS-10, LONG_EDGE_PIXELS-10}};
 
 
-#define numLayers 2
+#define numLayers 3
+Layer layer2 = {		/**< a 1 bit per pixel sprite */
+  (const AbShape *)&invader,
+  {screenWidth/2, 40},		/* position */
+  {0,0}, {0,0},				    /* last & next pos */
+  COLOR_WHITE,
+  0,
+};
 Layer layer1 = {
   (AbShape *)&rect10,
   {screenWidth/2, screenHeight/2}, /* position */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_RED,
-  0,
+  &layer2,
 };
 Layer layer0 = {
   (AbShape *)&rect10,
@@ -18,7 +18,7 @@ void buzzer_init()
     P2DIR = BIT6;		/* enable output to speaker (P2.6) */
 }
 
-void buzzer_set_period(short cycles) /* buzzer clock = 2MHz.  (period of 1k results in 2kHz tone) */
+void buzzer_set_period(short cycles) /* buzzer clock = TIMER_A_HZ (2MHz).  (period of 1k results in 2kHz tone) */
 {
   CCR0 = cycles; 
   CCR1 = cycles >> 1;		/* one half cycle */
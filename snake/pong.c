@@ -25,16 +25,16 @@ short goal = 1;
 
 
 
-AbRect middle = {abRectGetBounds, abRectCheck, {61, 0}};
-AbRect paddle = {abRectGetBounds, abRectCheck, {15, 3}};
+const AbRect middle = {abRectGetBounds, abRectCheck, {61, 0}};
+const AbRect paddle = {abRectGetBounds, abRectCheck, {15, 3}};
 
-AbRectOutline fieldOutline = {	/* playing field */
+const AbRectOutline fieldOutline = {	/* playing field */
   abRectOutlineGetBounds, abRectOutlineCheck,   
   {screenWidth/2 -2, screenHeight/2-2}
 };
 
 Layer fieldLayer = {		/* playing field as a layer */
-  (AbShape *) &fieldOutline,
+  (const AbShape *) &fieldOutline,
   {screenWidth/2, screenHeight/2},/**< center */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_BLACK,
@@ -43,7 +43,7 @@ Layer fieldLayer = {		/* playing field as a layer */
 
 //THIS IS THE BLACK LINE IN THE MIDDLE OF THE SCREEN
 Layer layer3 = {
-  (AbShape *)&middle,
+  (const AbShape *)&middle,
     {(screenWidth/2), (screenHeight/2)}, //line is set horizontally accross the screen
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_BLACK, //line is black
@@ -53,7 +53,7 @@ Layer layer3 = {
 
 //THIS IS FOR THE BOTTOM LEFT PAD
 Layer layer2 = {		/**< player 2 */
-  (AbShape *)&paddle,
+  (const AbShape *)&paddle,
   {(screenWidth/4), (screenHeight-6)}, //set close to the bottom left of the screen
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_GREEN, //line is green
@@ -62,7 +62,7 @@ Layer layer2 = {		/**< player 2 */
 
 //THIS IS FOR THE ORANGE PAD ON THE TOP MIDDLE 
 Layer layer1 = {		/**< player 1 */
-  (AbShape *)&paddle,
+  (const AbShape *)&paddle,
   {screenWidth/2, (6)}, 
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_ORANGE, //pad is orange
@@ -71,7 +71,7 @@ Layer layer1 = {		/**< player 1 */
 
 //BALL STARTS AT THE CENTER OF THE SCREEN
 Layer layer0 = {	    
-  (AbShape *)&circle14,
+  (const AbShape *)&circle14,
   {(screenWidth/2), (screenHeight/2)}, /**< bit below & right of center */
   {0,0}, {0,0},				    /* last & next pos */
   COLOR_BLACK, //ball is set to black
@@ -98,39 +98,16 @@ MovLayer ml0 = { &layer0, {5,5}, 0 };
 
 void movLayerDraw(MovLayer *movLayers, Layer *layers)
 {
-  int row, col;
   MovLayer *movLayer;
 
   and_sr(~8);			/**< disable interrupts (GIE off) */
   for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
     Layer *l = movLayer->layer;
-    l->posLast = l->pos;
     l->pos = l->posNext;
   }
   or_sr(8);			/**< disable interrupts (GIE on) */
 
-
-  for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
-    Region bounds;
-    layerGetBounds(movLayer->layer, &bounds);
-    lcd_setArea(bounds.topLeft.axes[0], bounds.topLeft.axes[1], 
-		bounds.botRight.axes[0], bounds.botRight.axes[1]);
-    for (row = bounds.topLeft.axes[1]; row <= bounds.botRight.axes[1]; row++) {
-      for (col = bounds.topLeft.axes[0]; col <= bounds.botRight.axes[0]; col++) {
-	Vec2 pixelPos = {col, row};
-	u_int color = bgColor;
-	Layer *probeLayer;
-	for (probeLayer = layers; probeLayer; 
-	     probeLayer = probeLayer->next) { /* probe all layers, in order */
-	  if (abShapeCheck(probeLayer->abShape, &probeLayer->pos, &pixelPos)) {
-	    color = probeLayer->color;
-	    break; 
-	  } /* if probe check */
-	} // for checking all layers at col, row
-	lcd_writeColor(color); 
-      } // for col
-    } // for row
-  } // for moving layer being updated
+  layerRedrawDirty(layers);	/**< repaint where layers left and arrived */
 }	  
 
 //This method was created as a helper to know when to exit the game.
@@ -170,8 +147,6 @@ int keepTrackScore(){
   return 0;
 }
 
-Region fence = {{0,LONG_EDGE_PIXELS}, {SHORT_EDGE_PIXELS, LONG_EDGE_PIXELS}}; /**< Create a fence region */
-
 /** Advances a moving shape within a fence
  *  
  *  \param ml0 The moving ball
@@ -233,9 +208,9 @@ void mlAdvance(MovLayer *ml, MovLayer *ml1, MovLayer *ml2, Region *fence)
         ml2->layer->color = COLOR_RED;
 	buzzer_set_period(150);
         score2++; // increments score if player is hit
-	drawString8x12((screenWidth/2)/2, (screenHeight/2)+50, "score!", COLOR_YELLOW, COLOR_BLACK);
+	renderString((screenWidth/2)/2, (screenHeight/2)+50, "score!", RENDER_FONT_8X12, COLOR_YELLOW, COLOR_BLACK); /**< drawn by main */
 	
-	drawChar8x12((screenWidth/2)/2, (screenHeight/2)/+15, score2, COLOR_YELLOW, COLOR_BLACK);
+	renderChar((screenWidth/2)/2, (screenHeight/2)/+15, score2, RENDER_FONT_8X12, COLOR_YELLOW, COLOR_BLACK);
 
         goal = 1;
 	      newPos.axes[0] = screenWidth/2;
@@ -262,6 +237,12 @@ int redrawScreen = 1;
 
 Region fieldFence;		/**< fence around playing field  */
 
+int ballTick(SoftTimer *timer);
+SoftTimer ballTimer = { ballTick, 61 }; /**< every 61ms */
+volatile u_char ballTicks = 0;	/**< ticks main has yet to advance the ball for */
+
+RenderCmd renderQueue[2];	/**< a goal queues its text and the score */
+
 
 /** Initializes everything, enables interrupts and green LED, 
  *  and handles the rendering for the screen
@@ -289,6 +270,7 @@ void main()
   //}
   lcd_init();
   shapeInit();
+  abCircleInit();
   p2sw_init(1);
   buzzer_init();
   switch_init();
@@ -299,32 +281,35 @@ void main()
   layerDraw(&layer0);
   drawTriangle((screenWidth/2)-60, screenHeight/2, 20, COLOR_ORANGE);
   layerGetBounds(&fieldLayer, &fieldFence);
+  renderInit(renderQueue, 2);
 
-  enableWDTInterrupts();      /**< enable periodic interrupt */
+  softTimerInit();
+  softTimerStart(&ballTimer, 61); /**< advance the ball every 61ms */
   or_sr(0x8);	              /**< GIE (enable interrupts) */
   
   for(;;) { 
-    while (!redrawScreen) { /**< Pause CPU if screen doesn't need updating */
+    while (!ballTicks) {      /**< Pause CPU until the ball is due to move */
       P1OUT &= ~GREEN_LED;    /**< Green led off witHo CPU */
       or_sr(0x10);	      /**< CPU OFF */
     }
     P1OUT |= GREEN_LED;       /**< Green led on when CPU on */
-    redrawScreen = 0;
-    movLayerDraw(&ml0, &layer0);
+    and_sr(~8);
+    ballTicks--;
+    or_sr(8);
+    mlAdvance(&ml0, &ml1, &ml2, &fieldFence); /**< here, not on the timer interrupt's stack */
+    if (p2sw_read() || renderPending())
+      redrawScreen = 1;
+    if (redrawScreen) {
+      redrawScreen = 0;
+      movLayerDraw(&ml0, &layer0);
+      renderDrain();	      /**< text queued by mlAdvance */
+    }
   }
 }
 
-/** Watchdog timer interrupt handler. 15 interrupts/sec */
-void wdt_c_handler()
+/** Ball timer callback, every 61ms (formerly every 15 watchdog interrupts) */
+int ballTick(SoftTimer *timer)
 {
-  static short count = 0;
-  P1OUT |= GREEN_LED;		      /**< Green LED on when cpu on */
-  count ++;
-  if (count == 15) {
-    mlAdvance(&ml0, &ml1, &ml2, &fieldFence);
-    if (p2sw_read())
-      redrawScreen = 1;
-    count = 0;
-  } 
-  P1OUT &= ~GREEN_LED;		    /**< Green LED off when cpu off */
+  ballTicks++;
+  return 1;			    /**< wake main to advance the ball */
 }
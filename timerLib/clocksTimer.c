@@ -1,27 +1,71 @@
 #include <msp430.h>
 #include "libTimer.h"
 
+static unsigned char smclkShift = CLOCKS_SMCLK_2MHZ; /* SMCLK = DCO >> smclkShift */
+
 void configureClocks(){
+  configureClocksProfile(CLOCKS_SMCLK_2MHZ);
+}
+
+/* Set SMCLK = DCO >> profile.  If USCI_B0 (the LCD's SPI bus) already
+ * runs from SMCLK, its divider follows, as lcd_init() would set it: 2 at
+ * 16MHz, since the ST7735 takes at most 15MHz, otherwise 1.
+ */
+static void setSmclk(unsigned char profile)
+{
+  unsigned char spiOn = (UCB0CTL1 & (UCSSEL_3 | UCSWRST)) == UCSSEL_2;
+  unsigned char txie = IE2 & UCB0TXIE;
+  if (spiOn)
+    while (UCB0STAT & UCBUSY)	// last byte shifts out at the old rate
+      ;
+  smclkShift = profile & 3;
+  BCSCTL2 &= ~(SELS | DIVS_3); // SMCLK source = DCO
+  BCSCTL2 |= smclkShift * DIVS_1; // SMCLK = DCO >> profile
+  if (spiOn) {
+    UCB0CTL1 |= UCSWRST;	// divider may only change in reset,
+    UCB0BR0 = smclkShift ? 1 : 2;
+    UCB0CTL1 &= ~UCSWRST;
+    IE2 |= txie;		// which clears the transmit interrupt enable
+  }
+}
+
+void configureClocksProfile(unsigned char profile){
+  unsigned char wdtOn = IE1 & WDTIE;
   WDTCTL = WDTPW + WDTHOLD;//Disable Watchdog Timer
   BCSCTL1 = CALBC1_16MHZ;  // Set DCO to 16 Mhz
   DCOCTL = CALDCO_16MHZ;
-    
-  BCSCTL2 &= ~(SELS);     // SMCLK source = DCO
-  BCSCTL2 |= DIVS_3;      // SMCLK = DCO / 8
+
+  setSmclk(profile);
+  if (wdtOn)			// restart it (at a profile that keeps its rate)
+    enableWDTInterrupts();
+}
+
+unsigned long smclkHz()
+{
+  return 16000000L >> smclkShift;
 }
 
 
-// enable watchdog timer periodic interrupt
-// period = SMCLOCK/32k
+// enable watchdog timer periodic interrupt, at 244Hz
+// period = SMCLK/8192 (2MHz) or SMCLK/32k (8MHz).  The watchdog has no
+// divider that gives 244Hz at 4 or 16MHz, so those profiles drop to
+// 2 or 8MHz while it is enabled.
 void enableWDTInterrupts()  
 {
+  if (!(smclkShift & 1))	// 4 or 16MHz
+    setSmclk(smclkShift + 1);
   WDTCTL = WDTPW |	   // passwd req'd.  Otherwise device resets
     WDTTMSEL |		     // watchdog interval mode 
     WDTCNTCL |		     // clear watchdog count
-    1;			     // divide SMCLK by 8192
+    (smclkShift >> 1);	     // 1: divide SMCLK by 8192, 0: by 32768
   IE1 |= WDTIE;		   // Enable watchdog interval timer interrupt
 }
 
+unsigned int wdtInterruptHz()
+{
+  return smclkHz() >> ((smclkShift >> 1) ? 13 : 15);
+}
+
 
 void timerAUpmode()
 {
@@ -31,8 +75,7 @@ void timerAUpmode()
   
   // Timer A control:
   //  Timer clock source 2: system clock (SMCLK)
+  //  Input divider: SMCLK / TIMER_A_HZ
   //  Mode Control 1: continuously 0...CCR0
-  TACTL = TASSEL_2 + MC_1;   
+  TACTL = TASSEL_2 + MC_1 + (CLOCKS_SMCLK_2MHZ - smclkShift) * ID_1;
 }
-
-
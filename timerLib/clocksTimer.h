@@ -1,8 +1,40 @@
 #ifndef timerLib_included
 #define timerLib_included
 
-void configureClocks();
+/* Clock profiles: the CPU (MCLK) always runs at 16MHz from the DCO, and
+ * SMCLK = 16MHz >> profile.  SMCLK clocks the LCD's SPI bus, so faster
+ * profiles send pixels faster.  Timer A and the watchdog interval
+ * are rescaled for the profile (see below).
+ */
+#define CLOCKS_SMCLK_16MHZ 0
+#define CLOCKS_SMCLK_8MHZ  1
+#define CLOCKS_SMCLK_4MHZ  2
+#define CLOCKS_SMCLK_2MHZ  3	/* configureClocks() */
+
+/* Timer A counts at 2MHz in every profile (its input divider makes up
+ * the difference), so buzzer periods are always in 2MHz cycles.
+ */
+#define TIMER_A_HZ 2000000L
+
+void configureClocks();		/* SMCLK = 2MHz */
+void configureClocksProfile(unsigned char profile);
+unsigned long smclkHz();
+
+/* Profiles may be changed before or after lcd_init(): the LCD's SPI
+ * divider is kept so that the bus never exceeds 8MHz.
+ *
+ * The watchdog interrupt always runs at 244Hz (wdtInterruptHz()), so
+ * tick counts keep their meaning.  The watchdog cannot divide 4 or
+ * 16MHz down to 244Hz, so while its interrupt is enabled those
+ * profiles run at 2 and 8MHz instead.  enableWDTInterrupts() leaves handling it to the program (e.g. its own
+ * wdt_handler.s).  enableWDTHandler() instead uses timerLib's C
+ * handler, which calls the program's wdt_c_handler(); only programs
+ * that call enableWDTHandler() link it.
+ */
 void enableWDTInterrupts();
+void enableWDTHandler();
+unsigned int wdtInterruptHz();
+
 void timerAUpmode();
 
 #endif
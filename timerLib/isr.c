@@ -0,0 +1,22 @@
+#include <msp430.h>
+#include "libTimer.h"
+
+volatile unsigned char isrWakeRequested;
+
+unsigned int
+isrInterruptCycles(volatile unsigned char *ifgReg, unsigned char ifgBit)
+{
+  /* MCLK is 16MHz: SMCLK divider plus Timer A1's input divider */
+  unsigned char shift = ((BCSCTL2 & DIVS_3) >> 1) + ((TA1CTL & ID_3) >> 6);
+  int sr = get_sr();
+  unsigned int t0, t1, t2, t3;
+  or_sr(GIE);
+  t0 = TA1R;
+  *ifgReg |= 0;			/* the same instructions, no interrupt */
+  t1 = TA1R;
+  t2 = TA1R;
+  *ifgReg |= ifgBit;		/* taken after this instruction */
+  t3 = TA1R;
+  set_sr(sr);
+  return ((t3 - t2) - (t1 - t0)) << shift;
+}
@@ -3,5 +3,9 @@
 
 #include "clocksTimer.h"
 #include "sr.h"
+#include "softTimer.h"
+#include "profile.h"
+#include "eventRing.h"
+#include "isr.h"
 
 #endif // included
@@ -0,0 +1,105 @@
+#include <msp430.h>
+#include "libTimer.h"
+#include "profile.h"
+
+ProfileProbe profileProbes[PROFILE_PROBES];
+unsigned char profileCyclesPerCount = 1;
+
+static unsigned char cycleShift;	/* cycles = counts << cycleShift */
+static unsigned int overflows;		/* high word of the count */
+static unsigned int overhead;		/* counts taken by profileNow itself */
+
+void
+profileInit()
+{
+  if (!(TA1CTL & MC_2))		/* softTimer not running: count SMCLK */
+    TA1CTL = TASSEL_2 + ID_0 + MC_2 + TACLR;
+  TA1CTL |= TAIE;
+  /* MCLK is 16MHz: SMCLK divider plus Timer A1's input divider */
+  cycleShift = ((BCSCTL2 & DIVS_3) >> 1) + ((TA1CTL & ID_3) >> 6);
+  profileCyclesPerCount = 1 << cycleShift;
+  overhead = 0;
+  {
+    unsigned long t0 = profileNow();
+    overhead = profileNow() - t0;
+  }
+}
+
+unsigned long
+profileNow()
+{
+  int sr = get_sr();
+  unsigned int hi, lo;
+  and_sr(~GIE);
+  hi = overflows;
+  lo = TA1R;
+  if ((TA1CTL & TAIFG) && lo < 0x8000) /* wrapped, interrupt pending */
+    hi++;
+  set_sr(sr);
+  return ((unsigned long)hi << 16) | lo;
+}
+
+void
+profileEnd(ProfileProbe *probe, const char *name)
+{
+  unsigned long cycles = profileNow() - probe->start;
+  cycles = (cycles > overhead ? cycles - overhead : 0) << cycleShift;
+  if (!probe->count || cycles < probe->min)
+    probe->min = cycles;
+  if (cycles > probe->max)
+    probe->max = cycles;
+  probe->total += cycles;
+  probe->count++;
+  probe->name = name;
+}
+
+void
+profileReset()
+{
+  static const ProfileProbe zeroProbe;
+  unsigned char i;
+  for (i = 0; i < PROFILE_PROBES; i++)
+    profileProbes[i] = zeroProbe;
+}
+
+/* Timer A1 overflow (CCR1, CCR2 are unused) */
+void
+__interrupt_vec(TIMER1_A1_VECTOR) profileOverflow()
+{
+  if (TA1IV == TA1IV_TAIFG)
+    overflows++;
+}
+
+static void
+putNumber(void (*putChar)(char c), unsigned long n)
+{
+  char digits[10];
+  unsigned char i = 0;
+  do {
+    digits[i++] = '0' + n % 10;
+    n /= 10;
+  } while (n);
+  putChar(' ');
+  while (i)
+    putChar(digits[--i]);
+}
+
+void
+profileDump(void (*putChar)(char c))
+{
+  unsigned char i;
+  for (i = 0; i < PROFILE_PROBES; i++) {
+    ProfileProbe *p = &profileProbes[i];
+    const char *s;
+    if (!p->count)
+      continue;
+    for (s = p->name; *s; s++)
+      putChar(*s);
+    putNumber(putChar, p->count);
+    putNumber(putChar, p->min);
+    putNumber(putChar, p->max);
+    putNumber(putChar, p->total);
+    putChar('\r');
+    putChar('\n');
+  }
+}
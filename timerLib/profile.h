@@ -0,0 +1,63 @@
+#ifndef profile_included
+#define profile_included
+
+/* Cycle profiling
+ *
+ * Timer A1 counts continuously and its overflow interrupt extends the
+ * count to 32 bits.  Code between PROFILE_BEGIN(probe) and
+ * PROFILE_END(probe) is timed, and profileProbes[probe] accumulates
+ * the number of runs and their min, max and total cycles.  probe is a
+ * small integer (e.g. an enum) below PROFILE_PROBES; its name, as
+ * written in PROFILE_END, is recorded with it.
+ *
+ * The macros are compiled in only when the program is built with
+ * -DPROFILE; otherwise they are empty and nothing else is linked.
+ *
+ * Times are exact MCLK cycles when SMCLK = MCLK (CLOCKS_SMCLK_16MHZ) and
+ * softTimer is not in use.  Otherwise Timer A1 counts more slowly and
+ * times are multiples of profileCyclesPerCount.  Probes that may run
+ * longer than 65536 counts need interrupts enabled, so that overflows
+ * are counted.
+ */
+
+#define PROFILE_PROBES 8
+
+typedef struct {
+  const char *name;		/* as written in PROFILE_END */
+  unsigned int count;		/* runs */
+  unsigned long min, max, total; /* cycles */
+  unsigned long start;		/* private */
+} ProfileProbe;
+
+extern ProfileProbe profileProbes[PROFILE_PROBES]; /* view in debugger */
+extern unsigned char profileCyclesPerCount;
+
+/* Start Timer A1 (if softTimerInit has not) and its overflow interrupt.
+ * Call after configureClocks() or configureClocksProfile() and
+ * softTimerInit().
+ */
+void profileInit();
+
+/* The 32 bit count of Timer A1 */
+unsigned long profileNow();
+
+/* Record a run of probe that began at probe->start */
+void profileEnd(ProfileProbe *probe, const char *name);
+
+/* Zero every probe */
+void profileReset();
+
+/* Write one line per probe that has run ("name count min max total"),
+ * a character at a time, e.g. to a serial port.
+ */
+void profileDump(void (*putChar)(char c));
+
+#ifdef PROFILE
+#define PROFILE_BEGIN(probe) (profileProbes[probe].start = profileNow())
+#define PROFILE_END(probe) profileEnd(&profileProbes[probe], #probe)
+#else
+#define PROFILE_BEGIN(probe)
+#define PROFILE_END(probe)
+#endif
+
+#endif // included
@@ -0,0 +1,119 @@
+#include <msp430.h>
+#include "libTimer.h"
+#include "softTimer.h"
+
+/* Timer A1 counts SMCLK/8: 250 << timerShift counts per ms, where
+ * timerShift is 0 for the 2MHz clock profile and 3 for 16MHz.
+ */
+static unsigned char timerShift;
+#define MAX_ARMED 0x8000	/* counts; well under the 16 bit wrap */
+
+static SoftTimer *timers;	/* sorted by deadline */
+static unsigned int epoch;	/* TA1R that the list's deltas start from */
+static unsigned int armed;	/* CCR0 = epoch + armed */
+
+static unsigned long
+msToCounts(unsigned int ms)
+{
+  unsigned long counts = ms;
+  counts = (counts << 8) - (counts << 2) - (counts << 1); /* ms * 250 */
+  return counts << timerShift;
+}
+
+/* program CCR0 for the first deadline */
+static void
+arm()
+{
+  if (!timers) {
+    TA1CCTL0 = 0;		/* nothing due: no interrupts */
+    return;
+  }
+  armed = timers->delta < MAX_ARMED ? timers->delta : MAX_ARMED;
+  TA1CCR0 = epoch + armed;
+  TA1CCTL0 = CCIE;		/* clears CCIFG, so check for a missed match */
+  if ((unsigned int)(TA1R - epoch) >= armed)
+    TA1CCTL0 |= CCIFG;		/* already due (callbacks ran long) */
+}
+
+/* insert timer delta counts after epoch */
+static void
+insertTimer(SoftTimer *timer, unsigned long delta)
+{
+  SoftTimer **pp = &timers;
+  while (*pp && (*pp)->delta <= delta) {
+    delta -= (*pp)->delta;
+    pp = &(*pp)->next;
+  }
+  if (*pp)
+    (*pp)->delta -= delta;
+  timer->delta = delta;
+  timer->next = *pp;
+  *pp = timer;
+}
+
+/* remove timer from the list, giving its delta to its successor.  True if it was running */
+static int
+removeTimer(SoftTimer *timer)
+{
+  SoftTimer **pp;
+  for (pp = &timers; *pp; pp = &(*pp)->next)
+    if (*pp == timer) {
+      if (timer->next)
+	timer->next->delta += timer->delta;
+      *pp = timer->next;
+      return 1;
+    }
+  return 0;
+}
+
+void
+softTimerInit()
+{
+  timerShift = CLOCKS_SMCLK_2MHZ - ((BCSCTL2 & DIVS_3) >> 1);
+  timers = 0;
+  TA1CCTL0 = 0;
+  TA1CTL = TASSEL_2 + ID_3 + MC_2 + TACLR; /* SMCLK/8, continuous */
+}
+
+void
+softTimerStart(SoftTimer *timer, unsigned int ms)
+{
+  int sr = get_sr();
+  and_sr(~GIE);			/* the list is shared with the handler */
+  if (!timers)
+    epoch = TA1R;
+  removeTimer(timer);
+  /* deltas count from epoch, which may be a while ago */
+  insertTimer(timer, (unsigned int)(TA1R - epoch) + msToCounts(ms));
+  if (timers->delta < armed || timers == timer)
+    arm();
+  set_sr(sr);
+}
+
+void
+softTimerStop(SoftTimer *timer)
+{
+  int sr = get_sr();
+  and_sr(~GIE);
+  if (removeTimer(timer) && !timers)
+    arm();			/* disables the interrupt */
+  set_sr(sr);
+}
+
+void
+__interrupt_vec(TIMER1_A0_VECTOR) softTimerInterrupt()
+{
+  epoch += armed;
+  if (timers)
+    timers->delta -= armed;
+  while (timers && timers->delta == 0) {
+    SoftTimer *timer = timers;
+    timers = timer->next;
+    if (timer->period)		/* from this deadline, so periods don't drift */
+      insertTimer(timer, msToCounts(timer->period));
+    if (timer->callback(timer))
+      isrWake();
+  }
+  arm();
+  ISR_EXIT_WAKE();
+}
@@ -0,0 +1,19 @@
+#include <msp430.h>
+#include "libTimer.h"
+
+void wdt_c_handler();		/* defined by the program */
+
+// enable the watchdog interrupt, handled by WDT() below.  Referencing
+// this is what links this file (and its vector) into the program.
+void enableWDTHandler()
+{
+  enableWDTInterrupts();
+}
+
+// calls the program's wdt_c_handler; see isr.h for waking main
+void
+__interrupt_vec(WDT_VECTOR) WDT()
+{
+  wdt_c_handler();
+  ISR_EXIT_WAKE();
+}